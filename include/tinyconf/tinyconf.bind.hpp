@@ -0,0 +1,233 @@
+#ifndef TINYCONF_BIND_HPP_
+#define TINYCONF_BIND_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.bind.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for configurations bound to the members of a struct
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include <functional>
+#include <unordered_map>
+
+#include "tinyconf.hpp"
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @class BasicBinding
+ * @brief Schema mapping keys of a configuration to the members of a struct
+ *
+ * Values are converted once, when loaded, so that hot code reads plain members instead of calling get().
+ * Loading from a file parses it straight into the struct: keys that are not bound are skipped without being stored.
+ * @tparam Struct : The struct holding the settings
+ * @tparam Grammar : Syntax policy of the parser (see stb::Syntax)
+ */
+template <typename Struct, typename Grammar = Syntax>
+class BasicBinding
+{
+public:
+    /*! @brief Type of the configurations read and written */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*! @brief Binding empty constructor */
+    BasicBinding() {}
+
+    //
+    // SCHEMA
+    //
+
+    /*!
+     * @brief Bind a key to a member holding a single value.
+     * Raw pointers own no storage to read into, strings are bound to std::string members.
+     * @param key : The full key
+     * @param member : The member to fill with the value of the key
+     * @return the binding, to chain declarations
+     */
+    template <typename T>
+    BasicBinding &bind(const std::string &key, T Struct::*member)
+    {
+        static_assert(!std::is_pointer<T>::value, "raw pointers cannot be bound, use std::string");
+        field entry;
+
+        entry.key = key;
+        entry.read = [member](const Value &stored, Struct &target) { config_type::convert(stored, target.*member); };
+        entry.write = [member](const Struct &source, config_type &config, const std::string &key) { config.set(key, source.*member); };
+        return (add(entry));
+    }
+
+    /*!
+     * @brief Bind a key to a member holding a pair of values
+     * @param key : The full key
+     * @param member : The pair to fill with the values of the key
+     * @return the binding, to chain declarations
+     */
+    template <typename Tx, typename Ty>
+    BasicBinding &bindPair(const std::string &key, std::pair<Tx, Ty> Struct::*member)
+    {
+        field entry;
+
+        entry.key = key;
+        entry.read = [member](const Value &stored, Struct &target) { config_type::convertPair(stored, target.*member); };
+        entry.write = [member](const Struct &source, config_type &config, const std::string &key) { config.setPair(key, source.*member); };
+        return (add(entry));
+    }
+
+    /*!
+     * @brief Bind a key to a member holding a container of values
+     * @param key : The full key
+     * @param member : The container to fill with the values of the key, cleared first
+     * @return the binding, to chain declarations
+     */
+    template <typename T>
+    BasicBinding &bindContainer(const std::string &key, T Struct::*member)
+    {
+        field entry;
+
+        entry.key = key;
+        entry.read = [member](const Value &stored, Struct &target) {
+            (target.*member).clear();
+            config_type::convertContainer(stored, target.*member);
+        };
+        entry.write = [member](const Struct &source, config_type &config, const std::string &key) { config.setContainer(key, source.*member); };
+        return (add(entry));
+    }
+
+    /*!
+     * @brief Get the number of keys bound
+     * @return The number of keys
+     */
+    size_t size() const
+    {
+        return (_fields.size());
+    }
+
+    //
+    // LOAD / SAVE
+    //
+
+    /*!
+     * @brief Load a configuration file straight into a struct, members of missing keys are left untouched
+     * Values are read as they are written, references to other keys are not expanded.
+     * @param path : The path to the configuration file
+     * @param target : The struct to fill
+     * @return true if every bound key was found, false otherwise
+     */
+    bool load(const std::string &path, Struct &target) const
+    {
+        std::vector<std::string> buffer = config_type::dump(path);
+        std::vector<bool> found(_fields.size(), false);
+        typename config_type::association pair;
+        std::string section;
+        bool comment = false;
+
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            if (config_type::formatBuffer(buffer[i], section, comment))
+            {
+                pair = config_type::parseBuffer(buffer[i]);
+                index_map::const_iterator it = _index.find(config_type::join(section, pair.first));
+
+                if (it == _index.end()) continue; //Not bound
+                _fields[it->second].read(Value::borrow(pair.second), target);
+                found[it->second] = true;
+            }
+        }
+        return (std::find(found.begin(), found.end(), false) == found.end());
+    }
+
+    /*!
+     * @brief Fill a struct from a configuration in memory, members of missing keys are left untouched
+     * @param config : The configuration to read
+     * @param target : The struct to fill
+     * @return true if every bound key was found, false otherwise
+     */
+    bool load(const config_type &config, Struct &target) const
+    {
+        bool complete = true;
+
+        for (size_t i = 0; i < _fields.size(); i++)
+        {
+            const Value *stored = config.find(_fields[i].key);
+
+            if (stored == NULL) complete = false;
+            else _fields[i].read(*stored, target);
+        }
+        return (complete);
+    }
+
+    /*!
+     * @brief Set every bound key of a configuration from a struct
+     * @param source : The struct to read
+     * @param config : The configuration to fill
+     */
+    void store(const Struct &source, config_type &config) const
+    {
+        for (size_t i = 0; i < _fields.size(); i++)
+        {
+            _fields[i].write(source, config, _fields[i].key);
+        }
+    }
+
+    /*!
+     * @brief Save a struct inside a configuration file.
+     * Lines of the file are kept in place with their values updated, keys that are not bound are left untouched.
+     * @param source : The struct to save
+     * @param path : The path to the configuration file
+     */
+    void save(const Struct &source, const std::string &path) const
+    {
+        config_type config;
+
+        store(source, config);
+        config_type::write(path, *config.snapshot());
+    }
+
+protected:
+    /*! @brief Key bound to a member, with its conversions */
+    struct field
+    {
+        std::string key;
+        std::function<void(const Value &, Struct &)> read;
+        std::function<void(const Struct &, config_type &, const std::string &)> write;
+    };
+    /*! @brief Container used to find the field of a full key */
+    typedef std::unordered_map<std::string, size_t> index_map;
+
+    /*!
+     * @brief Register a field, replacing the one bound to the same key
+     * @param entry : The field to register
+     * @return the binding, to chain declarations
+     */
+    BasicBinding &add(const field &entry)
+    {
+        index_map::const_iterator it = _index.find(entry.key);
+
+        if (it != _index.end())
+        {
+            _fields[it->second] = entry;
+            return (*this);
+        }
+        _index[entry.key] = _fields.size();
+        _fields.push_back(entry);
+        return (*this);
+    }
+
+    //
+    // MEMBERS
+    //
+
+    std::vector<field> _fields;
+    index_map _index;
+};
+
+/*! @brief Binding using the default grammar, defined in tinyconf.config.hpp */
+template <typename Struct>
+using Binding = BasicBinding<Struct>;
+
+}
+
+#endif /* !TINYCONF_BIND_HPP_ */
@@ -13,6 +13,8 @@
  * Separators (note the plural) represent "possible characters", where you can add custom values inside the define
  * Blocks and Separator values are string sequences to identify entities
  * The escape char should always be a single character.
+ * The defines only set the default grammar (stb::Syntax), other dialects can be declared
+ * by deriving from it, see stb::Syntax below.
  * * * * * * * * * * * * * * * * * * * * */
 
 /*! @brief This string contains the sequence that escapes the next char */
@@ -37,7 +39,59 @@
 #define KEY_VALUE_SEPARATOR     "="
 /*! @brief This is the char that separates multiple values in the field */
 #define VALUE_FIELD_SEPARATOR   ":"
+/*! @brief This sequence begins a reference to another key or environment variable inside a value */
+#define INTERPOLATION_BEGIN     "${"
+/*! @brief This sequence ends a reference to another key or environment variable inside a value */
+#define INTERPOLATION_END       "}"
 /*! @brief This is the number of digits that floats displays (including left-positioned digits) */
 #define DECIMAL_PRECISION       100
 
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @struct Syntax
+ * @brief Default grammar policy of the parser, built from the defines above
+ *
+ * Every config is parametrized on a grammar (see stb::BasicConfig), which is resolved at compile time.
+ * To declare another dialect, derive from this struct and hide the members you want to change:
+ *
+ *     struct MyDialect : stb::Syntax
+ *     {
+ *         static constexpr const char *keyValueSeparator() { return ("@"); }
+ *     };
+ *     stb::BasicConfig<MyDialect> cfg("./file.cfg");
+ */
+struct Syntax
+{
+    /*! @brief The char that escapes the next char */
+    static constexpr char escapeCharacter() { return (ESCAPE_CHARACTER); }
+    /*! @brief The characters that indicate a single line comment */
+    static constexpr const char *commentLineSeparators() { return (COMMENT_LINE_SEPARATORS); }
+    /*! @brief The sequence that begins a comment block */
+    static constexpr const char *commentBlockBegin() { return (COMMENT_BLOCK_BEGIN); }
+    /*! @brief The sequence that ends a comment block */
+    static constexpr const char *commentBlockEnd() { return (COMMENT_BLOCK_END); }
+    /*! @brief The sequence that separates the section from the key in the field */
+    static constexpr const char *sectionFieldSeparator() { return (SECTION_FIELD_SEPARATOR); }
+    /*! @brief The sequence that begins a section block */
+    static constexpr const char *sectionBlockBegin() { return (SECTION_BLOCK_BEGIN); }
+    /*! @brief The sequence that ends a section block */
+    static constexpr const char *sectionBlockEnd() { return (SECTION_BLOCK_END); }
+    /*! @brief The characters that can brace strings */
+    static constexpr const char *stringIdentifiers() { return (STRING_IDENTIFIERS); }
+    /*! @brief The sequence between the key and the value */
+    static constexpr const char *keyValueSeparator() { return (KEY_VALUE_SEPARATOR); }
+    /*! @brief The sequence that separates multiple values in the field */
+    static constexpr const char *valueFieldSeparator() { return (VALUE_FIELD_SEPARATOR); }
+    /*! @brief The sequence that begins a reference inside a value, empty to disable interpolation */
+    static constexpr const char *interpolationBegin() { return (INTERPOLATION_BEGIN); }
+    /*! @brief The sequence that ends a reference inside a value */
+    static constexpr const char *interpolationEnd() { return (INTERPOLATION_END); }
+    /*! @brief The number of digits that floats displays */
+    static constexpr int decimalPrecision() { return (DECIMAL_PRECISION); }
+};
+
+}
+
 #endif /* !TINYCONF_CONFIG_HPP */
\ No newline at end of file
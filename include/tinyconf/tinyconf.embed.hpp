@@ -0,0 +1,430 @@
+#ifndef TINYCONF_EMBED_HPP_
+#define TINYCONF_EMBED_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.embed.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for configurations embedded in the binary, parsed at compile time
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include "tinyconf.hpp"
+
+/*!
+ * @brief Declares an embedded configuration parsed at compile time
+ * @param Name : The name of the type to declare
+ * @param Text : A string literal holding the configuration
+ */
+#define TINYCONF_EMBED(Name, Text) \
+    struct Name##Source \
+    { \
+        static constexpr const char *text() { return (Text); } \
+        static constexpr size_t size() { return (sizeof(Text) - 1); } \
+    }; \
+    typedef stb::BasicEmbeddedConfig<Name##Source> Name
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @brief Compile-time parser of embedded configurations
+ *
+ * C++11 constexpr functions are a single return statement, so every scan splits its range in halves:
+ * the recursion depth stays logarithmic in the size of the text instead of linear.
+ * The subset of the syntax understood is one association per line, [Section] headers,
+ * blank lines and line comments. Block comments, quotes and escapes are not supported.
+ */
+namespace embed {
+
+/*! @brief Association of an embedded configuration, as offsets in its text */
+struct Field
+{
+    size_t section;
+    size_t sectionSize;
+    size_t key;
+    size_t keySize;
+    size_t value;
+    size_t valueSize;
+    uint64_t sectionPrefix; //First bytes of the section, big-endian, to order most fields without walking the text
+    uint64_t keyPrefix;
+};
+
+/*!
+ * @brief Scans the text of an embedded configuration
+ * @tparam Source : Type exposing the text through static text() and size() functions
+ * @tparam Grammar : Syntax policy of the text (see stb::Syntax)
+ */
+template <typename Source, typename Grammar>
+struct Parser
+{
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    static constexpr size_t size()
+    {
+        return (Source::size());
+    }
+
+    static constexpr char at(size_t i)
+    {
+        return (Source::text()[i]);
+    }
+
+    /*! @brief Tests if a sequence is present at given position, before end */
+    static constexpr bool matches(size_t pos, size_t end, const char *seq)
+    {
+        return (*seq == '\0' || (pos < end && at(pos) == *seq && matches(pos + 1, end, seq + 1)));
+    }
+
+    /*! @brief First position in [begin, end) holding a character of set, end if none */
+    static constexpr size_t first(size_t begin, size_t end, const char *set)
+    {
+        return (end - begin == 0 ? end
+              : end - begin == 1 ? (syntax::contains(set, at(begin)) ? begin : end)
+              : first(first(begin, begin + (end - begin) / 2, set), begin + (end - begin) / 2, end, set));
+    }
+
+    static constexpr size_t first(size_t left, size_t mid, size_t end, const char *set)
+    {
+        return (left != mid ? left : first(mid, end, set));
+    }
+
+    /*! @brief First position in [begin, end) that is not a space, end if none */
+    static constexpr size_t skip(size_t begin, size_t end)
+    {
+        return (end - begin == 0 ? end
+              : end - begin == 1 ? (at(begin) != ' ' ? begin : end)
+              : skip(skip(begin, begin + (end - begin) / 2), begin + (end - begin) / 2, end));
+    }
+
+    static constexpr size_t skip(size_t left, size_t mid, size_t end)
+    {
+        return (left != mid ? left : skip(mid, end));
+    }
+
+    /*! @brief First occurence of a sequence in [begin, end), end if none */
+    static constexpr size_t find(size_t begin, size_t end, const char *seq)
+    {
+        return (end - begin == 0 ? end
+              : end - begin == 1 ? (matches(begin, Source::size(), seq) ? begin : end)
+              : find(find(begin, begin + (end - begin) / 2, seq), begin + (end - begin) / 2, end, seq));
+    }
+
+    static constexpr size_t find(size_t left, size_t mid, size_t end, const char *seq)
+    {
+        return (left != mid ? left : find(mid, end, seq));
+    }
+
+    /*! @brief Last occurence of a sequence in [begin, end), end if none */
+    static constexpr size_t last(size_t begin, size_t end, const char *seq)
+    {
+        return (end - begin == 0 ? end
+              : end - begin == 1 ? (matches(begin, Source::size(), seq) ? begin : end)
+              : last(last(begin, begin + (end - begin) / 2, seq), begin + (end - begin) / 2, last(begin + (end - begin) / 2, end, seq), end));
+    }
+
+    static constexpr size_t last(size_t left, size_t mid, size_t right, size_t end)
+    {
+        return (right != end ? right : (left != mid ? left : end));
+    }
+
+    /*! @brief Position of the next line feed from given position, size of the text if none */
+    static constexpr size_t eol(size_t pos)
+    {
+        return (eol(pos, Source::size() - pos < 64 ? Source::size() : pos + 64));
+    }
+
+    /*! @brief Scans by chunks, so that the cost of a line does not depend on the text that follows */
+    static constexpr size_t eol(size_t pos, size_t bound)
+    {
+        return (first(pos, bound, "\n") == bound && bound != Source::size() ? eol(bound) : first(pos, bound, "\n"));
+    }
+
+    /*! @brief End of the line beginning at given position, comments excluded */
+    static constexpr size_t end(size_t line)
+    {
+        return (trim(line, first(line, eol(line), Grammar::commentLineSeparators())));
+    }
+
+    static constexpr size_t trim(size_t line, size_t end)
+    {
+        return (end > line && at(end - 1) == '\r' ? end - 1 : end);
+    }
+
+    /*! @brief Tests if the line beginning at given position is a section header */
+    static constexpr bool header(size_t line)
+    {
+        return (matches(skip(line, end(line)), end(line), Grammar::sectionBlockBegin()));
+    }
+
+    /*! @brief Tests if the line beginning at given position holds an association */
+    static constexpr bool association(size_t line)
+    {
+        return (skip(line, end(line)) != end(line) && !header(line)
+                && find(line, end(line), Grammar::keyValueSeparator()) != end(line));
+    }
+
+    /*! @brief First line beginning at or after given position that is a header or an association */
+    static constexpr size_t next(size_t line)
+    {
+        return (line >= Source::size() || header(line) || association(line) ? line : next(following(line)));
+    }
+
+    /*! @brief Beginning of the line that follows the one at given position */
+    static constexpr size_t following(size_t line)
+    {
+        return (eol(line) < Source::size() ? eol(line) + 1 : Source::size());
+    }
+
+    /*! @brief Association of the line at given position, under the section header at given position, split on the last separator as parseBuffer() does */
+    static constexpr Field field(size_t line, size_t section)
+    {
+        return (field(line, last(line, end(line), Grammar::keyValueSeparator()),
+                      (section == npos ? 0 : skip(section, end(section)) + syntax::length(Grammar::sectionBlockBegin())), section));
+    }
+
+    static constexpr Field field(size_t line, size_t sep, size_t name, size_t section)
+    {
+        return (field(name, (section == npos ? 0 : find(name, end(section), Grammar::sectionBlockEnd()) - name),
+                      line, sep - line,
+                      sep + syntax::length(Grammar::keyValueSeparator()), end(line) - sep - syntax::length(Grammar::keyValueSeparator())));
+    }
+
+    static constexpr Field field(size_t section, size_t sectionSize, size_t key, size_t keySize, size_t value, size_t valueSize)
+    {
+        return (Field{section, sectionSize, key, keySize, value, valueSize, prefix(section, sectionSize), prefix(key, keySize)});
+    }
+
+    /*! @brief First eight bytes of a slice of the text, big-endian and padded with zeros */
+    static constexpr uint64_t prefix(size_t pos, size_t size, size_t shift = 56)
+    {
+        return (size == 0 ? 0 : (static_cast<uint64_t>(static_cast<unsigned char>(at(pos))) << shift)
+                                | (shift == 0 ? 0 : prefix(pos + 1, size - 1, shift - 8)));
+    }
+
+    /*! @brief Compares two slices of the text, as std::string does */
+    static constexpr int compare(size_t a, size_t aSize, size_t b, size_t bSize)
+    {
+        return (aSize == 0 ? (bSize == 0 ? 0 : -1)
+              : bSize == 0 ? 1
+              : static_cast<unsigned char>(at(a)) != static_cast<unsigned char>(at(b))
+                ? (static_cast<unsigned char>(at(a)) < static_cast<unsigned char>(at(b)) ? -1 : 1)
+              : compare(a + 1, aSize - 1, b + 1, bSize - 1));
+    }
+
+    /*! @brief Tests if an association is ordered before another, later duplicates first */
+    static constexpr bool ordered(const Field &a, size_t aIndex, const Field &b, size_t bIndex)
+    {
+        return (a.sectionPrefix != b.sectionPrefix ? a.sectionPrefix < b.sectionPrefix
+              : ordered(compare(a.section, a.sectionSize, b.section, b.sectionSize), a, aIndex, b, bIndex));
+    }
+
+    static constexpr bool ordered(int section, const Field &a, size_t aIndex, const Field &b, size_t bIndex)
+    {
+        return (section != 0 ? section < 0
+              : a.keyPrefix != b.keyPrefix ? a.keyPrefix < b.keyPrefix
+              : ordered(compare(a.key, a.keySize, b.key, b.keySize), aIndex > bIndex));
+    }
+
+    static constexpr bool ordered(int key, bool later)
+    {
+        return (key != 0 ? key < 0 : later);
+    }
+};
+
+/*! @brief Association found on a line, under a section */
+template <typename Parser, size_t Line, size_t Section>
+struct Entry
+{
+    static constexpr Field field()
+    {
+        return (Parser::field(Line, Section));
+    }
+};
+
+/*! @brief Associations in order of appearance */
+template <typename... Entries>
+struct List
+{
+    static constexpr size_t size = sizeof...(Entries);
+    static constexpr Field table[sizeof...(Entries) + 1] = { Entries::field()..., Field{0, 0, 0, 0, 0, 0, 0, 0} };
+};
+
+template <typename... Entries>
+constexpr size_t List<Entries...>::size;
+
+template <typename... Entries>
+constexpr Field List<Entries...>::table[sizeof...(Entries) + 1];
+
+/*!
+ * @brief Walks the text line by line, appending an entry for every association
+ * Each line is parsed once by its own instantiation: constexpr calls are not shared between
+ * the elements of an array, so deriving every entry from the whole text would parse it again for each key.
+ * The depth of the walk is the number of headers and associations, bounded by -ftemplate-depth.
+ */
+template <typename Parser, size_t Line, size_t Section, typename Result, bool Done = (Line >= Parser::size())>
+struct Scan;
+
+template <typename Parser, size_t Line, size_t Section, typename... Entries>
+struct Scan<Parser, Line, Section, List<Entries...>, false>
+    : Scan<Parser, Parser::next(Parser::following(Line)), (Parser::header(Line) ? Line : Section),
+           typename std::conditional<Parser::header(Line), List<Entries...>, List<Entries..., Entry<Parser, Line, Section> > >::type>
+{
+};
+
+template <typename Parser, size_t Line, size_t Section, typename Result>
+struct Scan<Parser, Line, Section, Result, true>
+{
+    typedef Result type;
+};
+
+/*! @brief Associations of an embedded configuration in order of appearance */
+template <typename Source, typename Grammar>
+struct Fields : Scan<Parser<Source, Grammar>, Parser<Source, Grammar>::next(0), Parser<Source, Grammar>::npos, List<> >::type
+{
+};
+
+/*! @brief Rank of each association once sorted */
+template <typename Source, typename Grammar, typename Indexes = typename syntax::make_index_list<Fields<Source, Grammar>::size>::type>
+struct Ranks;
+
+template <typename Source, typename Grammar, size_t... I>
+struct Ranks<Source, Grammar, syntax::index_list<I...> >
+{
+    typedef Fields<Source, Grammar> fields;
+
+    /*! @brief Number of associations of [begin, end) ordered before the given one */
+    static constexpr size_t rank(size_t index, size_t begin = 0, size_t end = sizeof...(I))
+    {
+        return (end - begin == 0 ? 0
+              : end - begin == 1 ? (Parser<Source, Grammar>::ordered(fields::table[begin], begin, fields::table[index], index) ? 1 : 0)
+              : rank(index, begin, begin + (end - begin) / 2) + rank(index, begin + (end - begin) / 2, end));
+    }
+
+    static constexpr size_t table[sizeof...(I) + 1] = { rank(I)..., 0 };
+};
+
+template <typename Source, typename Grammar, size_t... I>
+constexpr size_t Ranks<Source, Grammar, syntax::index_list<I...> >::table[sizeof...(I) + 1];
+
+/*! @brief Associations sorted by section then by key */
+template <typename Source, typename Grammar, typename Indexes = typename syntax::make_index_list<Fields<Source, Grammar>::size>::type>
+struct Table;
+
+template <typename Source, typename Grammar, size_t... I>
+struct Table<Source, Grammar, syntax::index_list<I...> >
+{
+    typedef Ranks<Source, Grammar> ranks;
+
+    /*! @brief Index of the association of given rank, in [begin, end) */
+    static constexpr size_t at(size_t rank, size_t begin = 0, size_t end = sizeof...(I))
+    {
+        return (end - begin == 0 ? end
+              : end - begin == 1 ? (ranks::table[begin] == rank ? begin : end)
+              : at(at(rank, begin, begin + (end - begin) / 2), rank, begin + (end - begin) / 2, end));
+    }
+
+    static constexpr size_t at(size_t left, size_t rank, size_t mid, size_t end)
+    {
+        return (left != mid ? left : at(rank, mid, end));
+    }
+
+    static constexpr Field table[sizeof...(I) + 1] = { Fields<Source, Grammar>::table[at(I)]..., Field{0, 0, 0, 0, 0, 0, 0, 0} };
+};
+
+template <typename Source, typename Grammar, size_t... I>
+constexpr Field Table<Source, Grammar, syntax::index_list<I...> >::table[sizeof...(I) + 1];
+
+}
+
+/*!
+ * @class BasicEmbeddedConfig
+ * @brief Configuration embedded in the binary, parsed and sorted at compile time
+ *
+ * Declare one with TINYCONF_EMBED, then use it as the defaults of a configuration (see BasicConfig::setDefaults).
+ * Lookups are a binary search over a static table referencing the embedded text, without any allocation.
+ */
+template <typename Source, typename Grammar = Syntax, typename Indexes = typename syntax::make_index_list<embed::Fields<Source, Grammar>::size>::type>
+class BasicEmbeddedConfig;
+
+template <typename Source, typename Grammar, size_t... I>
+class BasicEmbeddedConfig<Source, Grammar, syntax::index_list<I...> >
+{
+public:
+    /*! @brief Syntax policy of the embedded text */
+    typedef Grammar grammar;
+
+    /*!
+     * @brief Get the number of keys
+     * @return The number of keys
+     */
+    static constexpr size_t size()
+    {
+        return (sizeof...(I));
+    }
+
+    /*!
+     * @brief Find the value of a key
+     * @param key : The full key
+     * @return A pointer to the value, NULL if undefined
+     */
+    static const Value *find(const std::string &key)
+    {
+        size_t sep = separator(key);
+        size_t sectionSize = (sep == std::string::npos ? 0 : sep);
+        size_t name = (sep == std::string::npos ? 0 : sep + syntax::length(Grammar::sectionFieldSeparator()));
+        size_t begin = 0, end = sizeof...(I);
+
+        while (begin < end) //Lower bound of (section, key)
+        {
+            size_t mid = begin + (end - begin) / 2;
+            const embed::Field &field = table::table[mid];
+            int order = compare(Source::text() + field.section, field.sectionSize, key.data(), sectionSize);
+
+            if (order == 0) order = compare(Source::text() + field.key, field.keySize, key.data() + name, key.size() - name);
+            if (order < 0) begin = mid + 1;
+            else end = mid;
+        }
+        if (begin == sizeof...(I)) return (NULL);
+        const embed::Field &field = table::table[begin];
+        if (compare(Source::text() + field.section, field.sectionSize, key.data(), sectionSize) != 0
+            || compare(Source::text() + field.key, field.keySize, key.data() + name, key.size() - name) != 0) return (NULL);
+        return (&values()[begin]);
+    }
+
+protected:
+    typedef embed::Table<Source, Grammar> table;
+
+    /*!
+     * @brief Find the separator between the section and the key, as BasicConfig does
+     * @param key : The full key
+     * @return The position of the first separator not escaped, npos for keys without section
+     */
+    static size_t separator(const std::string &key)
+    {
+        for (size_t cursor = key.find(Grammar::sectionFieldSeparator()); cursor != std::string::npos; cursor = key.find(Grammar::sectionFieldSeparator(), cursor + 1))
+        {
+            if (cursor == 0 || key[cursor - 1] != Grammar::escapeCharacter()) return (cursor); //check for non escaped sequence
+        }
+        return (std::string::npos);
+    }
+
+    /*! @brief Values of the sorted associations, referencing the embedded text */
+    static const Value *values()
+    {
+        static const Value values[sizeof...(I) + 1] = { Value::borrow(Source::text() + table::table[I].value, table::table[I].valueSize)..., Value() };
+
+        return (values);
+    }
+
+    static int compare(const char *a, size_t aSize, const char *b, size_t bSize)
+    {
+        int order = memcmp(a, b, std::min(aSize, bSize));
+
+        return (order != 0 ? order : (aSize < bSize ? -1 : (aSize > bSize ? 1 : 0)));
+    }
+};
+
+}
+
+#endif /* !TINYCONF_EMBED_HPP_ */
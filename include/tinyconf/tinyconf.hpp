@@ -10,14 +10,35 @@
  * * * * * * * * * * * * * * * * * * * * */
 
 #include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <limits>
+#include <type_traits>
+// Threading
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
 // Stl Containers
 #include <vector>
 #include <map>
+#include <set>
+#include <deque>
+#include <unordered_set>
+#include <atomic>
 
 /* include configuration of parser */
 #include "tinyconf.config.hpp"
@@ -26,214 +47,3067 @@
 namespace stb {
 
 /*!
- * @class Config
- * @brief Main Config class: Defines the whole library
+ * @brief Compile-time helpers used to specialize the parser on its grammar
+ */
+namespace syntax {
+
+/*! @brief constexpr strlen */
+constexpr size_t length(const char *str)
+{
+    return (*str == '\0' ? 0 : 1 + length(str + 1));
+}
+
+/*! @brief constexpr lookup of a character inside a set of characters */
+constexpr bool contains(const char *set, char c)
+{
+    return (*set != '\0' && (*set == c || contains(set + 1, c)));
+}
+
+/*! @brief Sequence of indexes, used to expand lookup tables */
+template <size_t... I>
+struct index_list {};
+
+/*! @brief Builds index_list<0, ..., N - 1> */
+template <size_t N, size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_index_list<0, I...>
+{
+    typedef index_list<I...> type;
+};
+
+/*!
+ * @brief Character class backed by a 256 entries table computed at compile time
+ * @tparam Set : Grammar element exposing its characters through a static chars() function
+ */
+template <typename Set, typename Indexes = typename make_index_list<256>::type>
+struct CharClass;
+
+template <typename Set, size_t... I>
+struct CharClass<Set, index_list<I...> >
+{
+    /*! @brief true for each character belonging to the class */
+    static constexpr bool table[sizeof...(I)] = { contains(Set::chars(), static_cast<char>(I))... };
+
+    /*! @brief Tests if a character belongs to the class */
+    static bool test(char c)
+    {
+        return (table[static_cast<unsigned char>(c)]);
+    }
+};
+
+template <typename Set, size_t... I>
+constexpr bool CharClass<Set, index_list<I...> >::table[sizeof...(I)];
+
+/*!
+ * @brief Sequence of the grammar, single character sequences are matched with a byte compare
+ * @tparam Seq : Grammar element exposing its sequence through a static chars() function
+ */
+template <typename Seq>
+struct Token
+{
+    /*! @brief Length of the sequence */
+    static constexpr size_t size()
+    {
+        return (length(Seq::chars()));
+    }
+
+    /*! @brief Tests if the sequence is present in buffer at given position */
+    static bool match(const std::string &buffer, size_t pos)
+    {
+        return (match(buffer, pos, std::integral_constant<bool, size() == 1>()));
+    }
+
+    /*! @brief Tests if the sequence is present in a memory block at given position, before end */
+    static bool match(const char *pos, const char *end)
+    {
+        return (size() > 0 && static_cast<size_t>(end - pos) >= size() && memcmp(pos, Seq::chars(), size()) == 0);
+    }
+
+    /*! @brief Finds the first occurence of the sequence in buffer, starting at given position */
+    static size_t find(const std::string &buffer, size_t pos = 0)
+    {
+        return (find(buffer, pos, std::integral_constant<bool, size() == 1>()));
+    }
+
+    /*! @brief Finds the first occurence of the sequence in a memory block, returns end if none */
+    static const char *scan(const char *begin, const char *end)
+    {
+        return (scan(begin, end, std::integral_constant<bool, size() == 1>()));
+    }
+
+private:
+    static bool match(const std::string &buffer, size_t pos, std::true_type)
+    {
+        return (pos < buffer.length() && buffer[pos] == Seq::chars()[0]);
+    }
+
+    static bool match(const std::string &buffer, size_t pos, std::false_type)
+    {
+        return (buffer.compare(pos, size(), Seq::chars()) == 0);
+    }
+
+    static size_t find(const std::string &buffer, size_t pos, std::true_type)
+    {
+        return (buffer.find(Seq::chars()[0], pos));
+    }
+
+    static size_t find(const std::string &buffer, size_t pos, std::false_type)
+    {
+        return (buffer.find(Seq::chars(), pos, size()));
+    }
+
+    static const char *scan(const char *begin, const char *end, std::true_type)
+    {
+        const void *found = memchr(begin, Seq::chars()[0], end - begin);
+
+        return (found == NULL ? end : static_cast<const char *>(found));
+    }
+
+    static const char *scan(const char *begin, const char *end, std::false_type)
+    {
+        return (std::search(begin, end, Seq::chars(), Seq::chars() + size()));
+    }
+};
+
+/*! @brief Declares a grammar element selector bound to a member of the Syntax policy */
+#define TINYCONF_GRAMMAR_ELEMENT(Name, member) \
+    template <typename Grammar> \
+    struct Name \
+    { \
+        static constexpr const char *chars() { return (Grammar::member()); } \
+    };
+
+TINYCONF_GRAMMAR_ELEMENT(CommentLine, commentLineSeparators)
+TINYCONF_GRAMMAR_ELEMENT(CommentBegin, commentBlockBegin)
+TINYCONF_GRAMMAR_ELEMENT(CommentEnd, commentBlockEnd)
+TINYCONF_GRAMMAR_ELEMENT(SectionField, sectionFieldSeparator)
+TINYCONF_GRAMMAR_ELEMENT(SectionBegin, sectionBlockBegin)
+TINYCONF_GRAMMAR_ELEMENT(SectionEnd, sectionBlockEnd)
+TINYCONF_GRAMMAR_ELEMENT(StringIdentifiers, stringIdentifiers)
+TINYCONF_GRAMMAR_ELEMENT(KeyValue, keyValueSeparator)
+TINYCONF_GRAMMAR_ELEMENT(ValueField, valueFieldSeparator)
+TINYCONF_GRAMMAR_ELEMENT(InterpolationBegin, interpolationBegin)
+TINYCONF_GRAMMAR_ELEMENT(InterpolationEnd, interpolationEnd)
+
+#undef TINYCONF_GRAMMAR_ELEMENT
+
+}
+
+/*!
+ * @class Value
+ * @brief Immutable value stored in memory, copies share the same characters
+ *
+ * A value references a slice of characters kept alive by a reference counted storage,
+ * so that identical values can be shared between keys and between configurations.
  */
-class Config
+class Value
 {
 public:
-    /*! @brief Type used to represent associations in memory */
-    typedef std::pair<std::string, std::string> association;
-    /*! @brief Container used to store associations in memory */
-    typedef std::map<std::string, std::string> association_map;
+    /*! @brief Hash functor, used to pool values */
+    struct Hash
+    {
+        size_t operator()(const Value &value) const
+        {
+            return (static_cast<size_t>(hash(value.data(), value.size())));
+        }
+    };
 
-    /*! @brief Config empty constructor */
-    Config() {}
+    /*!
+     * @brief Hash a block of characters (FNV-1a), stable across processes
+     * @param data : The characters to hash
+     * @param size : The number of characters
+     * @param seed : The hash of the characters preceding, to hash a sequence of blocks
+     * @return The hash
+     */
+    static uint64_t hash(const char *data, size_t size, uint64_t seed = 14695981039346656037ULL)
+    {
+        uint64_t hash = seed;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+        }
+        return (hash);
+    }
+
+    /*! @brief Function building the text of packed numbers */
+    typedef void (*formatter)(const void *elements, size_t count, std::string &text);
+
+    /*! @brief Empty value constructor */
+    Value() : _storage(NULL), _data(""), _size(0), _version(0) {}
 
     /*!
-     * @brief Config standard constructor
-     * @param path : The path where the file.cfg will reside
+     * @brief Value standard constructor, copies the characters into a new storage
+     * @param text : The characters of the value
      */
-    Config(const std::string &path, bool overwrite = false) : _path(path)
+    explicit Value(const std::string &text) : _storage(allocate(text.data(), text.size())), _size(text.size()), _version(0)
     {
-        load();
+        _data = reinterpret_cast<const char *>(_storage + 1);
     }
 
-    //
-    // FILE MANAGEMENT
-    //
+    /*! @brief Value copy constructor, shares the storage */
+    Value(const Value &other) : _storage(other._storage), _data(other._data), _size(other._size), _version(other._version)
+    {
+        if (_storage != NULL) _storage->refs++;
+    }
+
+    /*! @brief Value assignment, shares the storage */
+    Value &operator=(const Value &other)
+    {
+        Value copy(other);
+
+        std::swap(_storage, copy._storage);
+        std::swap(_data, copy._data);
+        std::swap(_size, copy._size);
+        std::swap(_version, copy._version);
+        return (*this);
+    }
+
+    /*! @brief Releases the storage when it is no longer shared */
+    ~Value()
+    {
+        if (_storage != NULL && --_storage->refs == 0) _storage->release(_storage);
+    }
 
     /*!
-     * @brief Get path of associated configuration file
-     * @return String containing the path of the current associated cfg file
+     * @brief Get a value referencing characters without owning them, the text must outlive it
+     * @param text : The characters to reference
+     * @return A value usable for lookups
      */
-    std::string getPath()
+    static Value borrow(const std::string &text)
     {
-        return (_path);
+        return (borrow(text.data(), text.size()));
     }
 
     /*!
-     * @brief Set path of associated configuration file
-     * @param path :  The path where the file.cfg will reside
+     * @brief Get a value referencing characters without owning them, the characters must outlive it
+     * @param data : The characters to reference
+     * @param size : The number of characters
+     * @return A value usable for lookups and conversions
      */
-    void setPath(const std::string &path)
+    static Value borrow(const char *data, size_t size)
     {
-        _path = path;
+        Value value;
+
+        value._data = data;
+        value._size = size;
+        return (value);
+    }
+
+    /*!
+     * @brief Get a value referencing the characters of a file mapped in memory, the mapping lives as long as a value references it
+     * @param path : The path to the file to map
+     * @return The value, empty if the file is empty
+     */
+    static Value map(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat status;
+        void *address;
+        Mapping *mapping;
+        Value value;
+
+        if (fd == -1) throw (std::runtime_error("bad file: "+path)); //Couldnt open
+        if (fstat(fd, &status) == -1 || status.st_size == 0)
+        {
+            close(fd);
+            return (value);
+        }
+        address = mmap(NULL, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); //The mapping keeps the file open
+        if (address == MAP_FAILED) throw (std::runtime_error("unable to map file: "+path));
+        mapping = static_cast<Mapping *>(::operator new(sizeof(Mapping)));
+        new (mapping) Mapping();
+        mapping->refs = 1;
+        mapping->release = &unmap;
+        mapping->address = address;
+        mapping->length = static_cast<size_t>(status.st_size);
+        mapping->file = file(status);
+        mappings()++;
+        {
+            std::lock_guard<std::mutex> lock(registry().lock);
+
+            registry().files[mapping->file]++;
+        }
+        value._storage = mapping;
+        value._data = static_cast<const char *>(address);
+        value._size = mapping->length;
+        return (value);
+    }
+
+    /*!
+     * @brief Get a part of a text value, sharing its storage
+     * @param offset : The position of the first character
+     * @param size : The number of characters
+     * @return The value
+     */
+    Value slice(size_t offset, size_t size) const
+    {
+        Value value(*this);
+
+        if (packed()) throw (std::runtime_error("packed value")); //Numbers have no stable characters !
+        value._data = _data + offset;
+        value._size = size;
+        return (value);
+    }
+
+    /*!
+     * @brief Get a value holding a packed array of numbers, its text is only built when first needed
+     * @param first : The first number to copy
+     * @param last : The end of the numbers to copy
+     * @param format : The function building the text of the numbers
+     * @param text : The text of the numbers if already known, NULL to build it when needed
+     * @return The value
+     */
+    template <typename T, typename Iterator>
+    static Value pack(Iterator first, Iterator last, formatter format, const Value *text = NULL)
+    {
+        size_t count = static_cast<size_t>(std::distance(first, last));
+        Packed *packed = static_cast<Packed *>(::operator new(offset() + count * sizeof(T)));
+        Value value;
+
+        new (packed) Packed();
+        packed->refs = 1;
+        packed->release = &unpack;
+        packed->type = tag<T>();
+        packed->count = count;
+        packed->width = sizeof(T);
+        packed->format = format;
+        packed->text = (text == NULL ? NULL : transcribe(text->data(), text->size()));
+        std::copy(first, last, reinterpret_cast<T *>(reinterpret_cast<char *>(packed) + offset()));
+        value._storage = packed;
+        value._data = NULL; //Characters are held by the packed storage
+        value._size = 0;
+        return (value);
+    }
+
+    /*! @brief Tests if the value holds packed numbers */
+    bool packed() const
+    {
+        return (_data == NULL && _storage != NULL);
+    }
+
+    /*! @brief Get the number of packed numbers, 0 for text values */
+    size_t count() const
+    {
+        return (packed() ? static_cast<const Packed *>(_storage)->count : 0);
+    }
+
+    /*!
+     * @brief Get the packed numbers of the value
+     * @return The numbers, NULL if the value does not hold numbers of type T
+     */
+    template <typename T>
+    const T *elements() const
+    {
+        if (!packed() || static_cast<const Packed *>(_storage)->type != tag<T>()) return (NULL);
+        return (reinterpret_cast<const T *>(reinterpret_cast<const char *>(_storage) + offset()));
+    }
+
+    /*! @brief Get the characters of the value, not null terminated */
+    const char *data() const
+    {
+        return (packed() ? reinterpret_cast<const char *>(text() + 1) : _data);
+    }
+
+    /*! @brief Get the number of characters of the value */
+    size_t size() const
+    {
+        return (packed() ? text()->size : _size);
+    }
+
+    /*! @brief Get the number of bytes holding the value, without building the text of packed numbers */
+    size_t bytes() const
+    {
+        if (!packed()) return (_size);
+        return (static_cast<const Packed *>(_storage)->count * static_cast<const Packed *>(_storage)->width);
+    }
+
+    /*! @brief Copy the value into a string */
+    std::string str() const
+    {
+        return (std::string(data(), size()));
+    }
+
+    /*! @brief Get the number of values sharing the storage, 0 for borrowed values */
+    size_t shares() const
+    {
+        return (_storage == NULL ? 0 : _storage->refs.load());
+    }
+
+    /*! @brief Tests if the value references the characters of a file mapped by map() */
+    bool mapped() const
+    {
+        return (_storage != NULL && _storage->release == &unmap);
+    }
+
+    /*!
+     * @brief Get the number of files mapped by map() that are still referenced, within the process
+     * @return The counter of live mappings
+     */
+    static std::atomic<size_t> &mappings()
+    {
+        static std::atomic<size_t> count(0);
+
+        return (count);
+    }
+
+    /*!
+     * @brief Tests if a file is mapped by map() and still referenced, within the process
+     * @param path : The path to the file
+     * @return true if values reference the characters of the file, false otherwise
+     */
+    static bool mapped(const std::string &path)
+    {
+        struct stat status;
+
+        if (mappings().load() == 0 || stat(path.c_str(), &status) == -1) return (false);
+        std::lock_guard<std::mutex> lock(registry().lock);
+
+        return (registry().files.count(file(status)) > 0);
+    }
+
+    /*! @brief Get the number of bytes allocated for the storage, 0 for borrowed or mapped values */
+    size_t allocated() const
+    {
+        if (mapped()) return (0); //Pages of the file, not allocated
+        if (packed())
+        {
+            const Text *text = static_cast<const Packed *>(_storage)->text.load(std::memory_order_acquire);
+
+            return (offset() + bytes() + (text == NULL ? 0 : sizeof(Text) + text->size));
+        }
+        return (_storage == NULL ? 0 : sizeof(Storage) + _size);
+    }
+
+    /*! @brief Get the generation of the configuration in which the value was stored, 0 if never stored */
+    uint64_t version() const
+    {
+        return (_version);
+    }
+
+    /*! @brief Get an identifier of the storage, equal for values sharing it */
+    const void *storage() const
+    {
+        return (_storage);
+    }
+
+    bool operator==(const Value &other) const
+    {
+        return (size() == other.size() && memcmp(data(), other.data(), size()) == 0);
+    }
+
+    bool operator!=(const Value &other) const
+    {
+        return (!(*this == other));
+    }
+
+    bool operator==(const std::string &other) const
+    {
+        return (other.compare(0, std::string::npos, data(), size()) == 0);
+    }
+
+    bool operator!=(const std::string &other) const
+    {
+        return (!(*this == other));
+    }
+
+    bool operator==(const char *other) const
+    {
+        return (strncmp(data(), other, size()) == 0 && other[size()] == '\0');
+    }
+
+protected:
+    template <typename> friend class BasicConfig;
+
+    /*! @brief Reference counted header of the characters */
+    struct Storage
+    {
+        std::atomic<size_t> refs;
+        void (*release)(Storage *);
+    };
+
+    /*!
+     * @brief Allocate a storage holding a copy of given characters, right after its header
+     * @param data : The characters to copy, NULL to leave them uninitialized
+     * @param size : The number of characters
+     * @return The storage, referenced once
+     */
+    static Storage *allocate(const char *data, size_t size)
+    {
+        Storage *storage = static_cast<Storage *>(::operator new(sizeof(Storage) + size));
+
+        new (storage) Storage();
+        storage->refs = 1;
+        storage->release = &deallocate;
+        if (size > 0 && data != NULL) memcpy(reinterpret_cast<char *>(storage + 1), data, size);
+        return (storage);
+    }
+
+    /*!
+     * @brief Get a value of given size, whose characters are written by the caller before it is shared
+     * @param size : The number of characters
+     * @return The value, owning its storage
+     */
+    static Value reserve(size_t size)
+    {
+        Value value;
+
+        value._storage = allocate(NULL, size);
+        value._data = reinterpret_cast<const char *>(value._storage + 1);
+        value._size = size;
+        return (value);
+    }
+
+    /*! @brief Release a storage allocated by allocate() */
+    static void deallocate(Storage *storage)
+    {
+        storage->~Storage();
+        ::operator delete(storage);
+    }
+
+    /*! @brief Identity of a file, its device and inode */
+    typedef std::pair<uint64_t, uint64_t> file_id;
+
+    /*! @brief Files mapped by map() that are still referenced, with their number of mappings */
+    struct Registry
+    {
+        std::mutex lock;
+        std::map<file_id, size_t> files;
+    };
+
+    /*! @brief Get the files mapped within the process */
+    static Registry &registry()
+    {
+        static Registry mapped;
+
+        return (mapped);
+    }
+
+    /*! @brief Get the identity of a file from its status */
+    static file_id file(const struct stat &status)
+    {
+        return (file_id(static_cast<uint64_t>(status.st_dev), static_cast<uint64_t>(status.st_ino)));
+    }
+
+    /*! @brief Reference counted mapping of a file */
+    struct Mapping : Storage
+    {
+        void *address;
+        size_t length;
+        file_id file;
+    };
+
+    /*! @brief Release a storage created by map() */
+    static void unmap(Storage *storage)
+    {
+        Mapping *mapping = static_cast<Mapping *>(storage);
+
+        munmap(mapping->address, mapping->length);
+        {
+            std::lock_guard<std::mutex> lock(registry().lock);
+            std::map<file_id, size_t>::iterator it = registry().files.find(mapping->file);
+
+            if (it != registry().files.end() && --it->second == 0) registry().files.erase(it);
+        }
+        mapping->~Mapping();
+        ::operator delete(mapping);
+        mappings()--;
+    }
+
+    /*! @brief Characters of packed numbers, followed by the characters */
+    struct Text
+    {
+        size_t size;
+    };
+
+    /*! @brief Reference counted header of packed numbers, followed by the numbers */
+    struct Packed : Storage
+    {
+        const void *type;
+        size_t count;
+        size_t width;
+        formatter format;
+        std::atomic<Text *> text;
+    };
+
+    /*! @brief Get the offset of the numbers from their header, aligned for any type */
+    static size_t offset()
+    {
+        return ((sizeof(Packed) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t));
+    }
+
+    /*! @brief Get an identifier unique to a type of numbers */
+    template <typename T>
+    static const void *tag()
+    {
+        static const char id = 0;
+
+        return (&id);
+    }
+
+    /*!
+     * @brief Allocate the text of packed numbers
+     * @param data : The characters to copy
+     * @param size : The number of characters
+     * @return The text
+     */
+    static Text *transcribe(const char *data, size_t size)
+    {
+        Text *text = static_cast<Text *>(::operator new(sizeof(Text) + size));
+
+        text->size = size;
+        if (size > 0) memcpy(reinterpret_cast<char *>(text + 1), data, size);
+        return (text);
+    }
+
+    /*!
+     * @brief Get the text of the packed numbers, built on first call.
+     * Concurrent first calls may both build it, only one of them is kept.
+     * @return The text
+     */
+    const Text *text() const
+    {
+        Packed *packed = static_cast<Packed *>(_storage);
+        Text *text = packed->text.load(std::memory_order_acquire);
+
+        if (text == NULL)
+        {
+            std::string buffer;
+            Text *built;
+
+            packed->format(reinterpret_cast<const char *>(packed) + offset(), packed->count, buffer);
+            built = transcribe(buffer.data(), buffer.size());
+            if (packed->text.compare_exchange_strong(text, built, std::memory_order_acq_rel)) text = built;
+            else ::operator delete(built); //Built concurrently, text holds the kept one
+        }
+        return (text);
+    }
+
+    /*! @brief Release a storage allocated by pack() */
+    static void unpack(Storage *storage)
+    {
+        Packed *packed = static_cast<Packed *>(storage);
+        Text *text = packed->text.load();
+
+        if (text != NULL) ::operator delete(text);
+        packed->~Packed();
+        ::operator delete(packed);
+    }
+
+    Storage *_storage;
+    const char *_data;
+    size_t _size;
+    uint64_t _version;
+};
+
+/*!
+ * @class PackedView
+ * @brief Read-only view over packed numbers of a value, keeping them alive without copying them
+ */
+template <typename T>
+class PackedView
+{
+public:
+    typedef const T *const_iterator;
+
+    /*! @brief Empty view constructor */
+    PackedView() : _elements(NULL), _count(0) {}
+
+    /*!
+     * @brief View constructor
+     * @param value : The value holding the numbers, the view is empty if it holds no numbers of type T
+     */
+    explicit PackedView(const Value &value) : _value(value), _elements(value.elements<T>()), _count(_elements == NULL ? 0 : value.count()) {}
+
+    const_iterator begin() const
+    {
+        return (_elements);
+    }
+
+    const_iterator end() const
+    {
+        return (_elements + _count);
+    }
+
+    const T &operator[](size_t index) const
+    {
+        return (_elements[index]);
+    }
+
+    size_t size() const
+    {
+        return (_count);
+    }
+
+    bool empty() const
+    {
+        return (_count == 0);
+    }
+
+protected:
+    Value _value;
+    const T *_elements;
+    size_t _count;
+};
+
+/*!
+ * @brief Read-only stream buffer over a memory block, used to convert values without copying them
+ */
+class MemoryBuffer : public std::streambuf
+{
+public:
+    MemoryBuffer(const char *data, size_t size)
+    {
+        assign(data, size);
+    }
+
+    /*! @brief Point the buffer to another memory block */
+    void assign(const char *data, size_t size)
+    {
+        char *begin = const_cast<char *>(data);
+
+        setg(begin, begin, begin + size);
+    }
+};
+
+/*!
+ * @struct ValidationError
+ * @brief Error found while loading a configuration, see BasicConfig::setSchema()
+ */
+struct ValidationError
+{
+    /*! @brief Line of the file holding the association, 0 when the error is about the whole configuration */
+    size_t line;
+    /*! @brief Full key concerned */
+    std::string key;
+    /*! @brief Description of the error */
+    std::string message;
+};
+
+/*!
+ * @struct MemoryReport
+ * @brief Memory used by a configuration, see BasicConfig::memoryUsage()
+ */
+struct MemoryReport
+{
+    /*! @brief Number of sections */
+    size_t sections;
+    /*! @brief Number of keys */
+    size_t keys;
+    /*! @brief Number of distinct values stored, values shared between keys are counted once */
+    size_t values;
+    /*! @brief Characters used by section names and keys */
+    size_t keyBytes;
+    /*! @brief Characters used by distinct values */
+    size_t valueBytes;
+    /*! @brief Characters saved by sharing values between keys */
+    size_t sharedBytes;
+    /*! @brief Estimation of the whole memory used, including containers overhead */
+    size_t total;
+};
+
+/*!
+ * @class IOWorker
+ * @brief Background thread running asynchronous file operations, in order of submission
+ */
+class IOWorker
+{
+public:
+    /*! @brief Type of the operations run by the worker */
+    typedef std::function<void()> task;
+
+    /*!
+     * @brief Get the worker shared by every configuration, started on first use
+     * @return The worker instance
+     */
+    static IOWorker &instance()
+    {
+        static IOWorker worker;
+        return (worker);
+    }
+
+    /*!
+     * @brief Queue an operation for the worker thread
+     * @param operation : The operation to run
+     */
+    void post(const task &operation)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!_thread.joinable()) _thread = std::thread(&IOWorker::run, this);
+        _tasks.push_back(operation);
+        _pending.notify_one();
+    }
+
+    /*! @brief Runs the remaining operations and stops the worker thread */
+    ~IOWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _pending.notify_one();
+        if (_thread.joinable()) _thread.join();
+    }
+
+private:
+    IOWorker() : _stop(false) {}
+    IOWorker(const IOWorker &);
+    IOWorker &operator=(const IOWorker &);
+
+    /*! @brief Worker thread loop */
+    void run()
+    {
+        for (;;)
+        {
+            task operation;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                _pending.wait(lock, [this]() { return (_stop || !_tasks.empty()); });
+                if (_tasks.empty()) return; //Stopped, and nothing left to run
+                operation = _tasks.front();
+                _tasks.pop_front();
+            }
+            operation();
+        }
+    }
+
+    std::deque<task> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _pending;
+    std::thread _thread;
+    bool _stop;
+};
+
+template <typename Grammar>
+class BasicConfigStack;
+template <typename Grammar>
+class BasicConfigPublisher;
+template <typename Grammar>
+class BasicSharedConfig;
+template <typename Struct, typename Grammar>
+class BasicBinding;
+template <typename Grammar>
+class BasicPatch;
+template <typename Grammar>
+class BasicTransaction;
+template <typename Grammar>
+class BasicSchema;
+
+/*!
+ * @class BasicConfig
+ * @brief Main Config class: Defines the whole library
+ * @tparam Grammar : Syntax policy of the parser (see stb::Syntax)
+ */
+template <typename Grammar = Syntax>
+class BasicConfig
+{
+public:
+    /*! @brief Type used to represent associations in memory */
+    typedef std::pair<std::string, std::string> association;
+    /*! @brief Container used to store the associations of a section in memory, with keys relative to the section */
+    typedef std::map<std::string, Value> association_map;
+    /*! @brief Container used to store sections in memory, sections are shared between copies until one of them writes */
+    typedef std::map<std::string, std::shared_ptr<association_map> > section_map;
+    /*! @brief Callback notified when an asynchronous operation completes, with the exception it raised if any */
+    typedef std::function<void(std::exception_ptr)> completion;
+    /*! @brief Lookup of the values of a base layer, such as BasicEmbeddedConfig::find */
+    typedef const Value *(*fallback)(const std::string &key);
+
+    /*! @brief Checks associations while they are loaded, see BasicSchema (tinyconf.schema.hpp) */
+    struct validator
+    {
+        virtual ~validator() {}
+
+        /*!
+         * @brief Check an association as it is loaded
+         * @param section : The section of the association
+         * @param key : The key, relative to the section
+         * @param value : The value, that can be replaced with its conversion
+         * @param line : The line of the file holding the association
+         * @param errors : The errors to append to
+         */
+        virtual void check(const std::string &section, const std::string &key, Value &value, size_t line, std::vector<ValidationError> &errors) const = 0;
+
+        /*!
+         * @brief Check the configuration once loaded
+         * @param config : The configuration loaded
+         * @param errors : The errors to append to
+         */
+        virtual void complete(const BasicConfig &config, std::vector<ValidationError> &errors) const = 0;
+    };
+
+    /*! @brief Config empty constructor */
+    BasicConfig() : _interning(false), _mapping(false), _defaults(NULL), _epoch(0), _batch(0) {}
+
+    /*!
+     * @brief Config standard constructor
+     * @param path : The path where the file.cfg will reside
+     */
+    BasicConfig(const std::string &path, bool overwrite = false) : _path(path), _interning(false), _mapping(false), _defaults(NULL), _epoch(0), _batch(0)
+    {
+        load();
+    }
+
+    //
+    // FILE MANAGEMENT
+    //
+
+    /*!
+     * @brief Get path of associated configuration file
+     * @return String containing the path of the current associated cfg file
+     */
+    std::string getPath()
+    {
+        return (_path);
+    }
+
+    /*!
+     * @brief Set path of associated configuration file
+     * @param path :  The path where the file.cfg will reside
+     */
+    void setPath(const std::string &path)
+    {
+        _path = path;
+    }
+
+
+    /*!
+     * @brief Checks if configuration is empty
+     * @return true if empty, false if not
+     */
+    bool empty()
+    {
+        if (_frozen) return (_frozen->slots.empty());
+        return (sections().empty());
+    }
+
+    /*!
+     * @brief Empties configuration keys and values in memory
+     */
+    void clear()
+    {
+        writable();
+        touch();
+        _config.reset();
+        _templates.reset();
+        _dependents.reset();
+        _pool.reset();
+    }
+
+    /*!
+     * @brief Reload configuration from associated file, nothing is parsed if neither the file nor the configuration changed since
+     */
+    void reload()
+    {
+        if (!modified() && !stale()) return; //Loading again would give the same configuration
+        relocate(_path);
+    }
+
+    /*!
+     * @brief Reset object and load another configuration file
+     * @param path : The path to the configuration file to relocate to
+     */
+    void relocate(const std::string &path)
+    {
+        _path = path;
+        clear();
+        load();
+    }
+
+    /*!
+     * @brief Removes associated configuration file from disk
+     * @return true on success, false on failure
+     */
+    bool destroy()
+    {
+        if (getPath().empty()) throw(std::runtime_error("no_file_bound")); //No file bound to configuration
+        return (destroy(_path));
+    }
+
+    /*!
+     * @brief Removes a given configuration file from disk
+     * @param path : The path to the configuration file to delete
+     * @return true on success, false on failure
+     */
+    static bool destroy(const std::string &path)
+    {
+        return (remove(path.c_str()) == 0);
+    }
+
+    //
+    // GETTERS
+    //
+
+    /*!
+     * @brief Tests if a key exists in configuration
+     * @param key : The key to search for
+     * @return true if found, false if failed
+     */
+    bool exists(const std::string &key)
+    {
+        return (find(key) != NULL);
+    }
+
+    /*!
+     * @brief Get the version of a key, changed every time the key is set, erased or reloaded.
+     * Versions are unique within the process, a cache built from a value is still valid while the version is the same.
+     * @param key : The key to search for
+     * @return The version, 0 if undefined or only defined by the defaults
+     */
+    uint64_t version(const std::string &key) const
+    {
+        const Value *stored = find(key);
+
+        return (stored == NULL ? 0 : stored->version());
+    }
+
+    /*!
+     * @brief Get the keys whose values reference a key, directly or through other references
+     * @param key : The referenced key
+     * @return The keys expanded again when the key changes, in order of expansion
+     */
+    std::vector<std::string> dependents(const std::string &key) const
+    {
+        std::vector<std::string> keys;
+
+        if (_frozen) //References are only kept by the table
+        {
+            BasicConfig thawed(*this);
+
+            thawed.thaw();
+            return (thawed.dependents(key));
+        }
+        collect(key, keys);
+        return (keys);
+    }
+
+    /*!
+     * @brief Get the version of the whole configuration, changed by every modification
+     * @return The version of the last modification, 0 if never modified
+     */
+    uint64_t epoch() const
+    {
+        return (_epoch);
+    }
+
+    /*!
+     * @brief Tests if a value equals a given param in configuration
+     * @param key : The key to search for
+     * @return true if equals, false if not
+     */
+    template <typename T>
+    bool compare(const std::string &key, const T &value)
+    {
+        const Value *stored = find(key);
+
+        if (stored != NULL)
+        {
+            if (*stored == value)
+                return (true);
+        }
+        return (false);
+    }
+
+    /*!
+     * @brief Get arithmetic values from configuration
+     * @param key : The key identifying wanted value
+     * @param value : The arithmetic-typed variable to set with value
+     * @return true if found, false if failed
+     */
+    template <typename T>
+    bool get(const std::string &key, T &value)
+    {
+        const Value *stored = find(key);
+
+        if (stored == NULL) return (false);
+        convert(*stored, value);
+        return (true);
+    }
+
+    /*!
+     * @brief Get C-style string values from configuration
+     * @param key : The key identifying wanted value
+     * @param value : The char array to set with value
+     * @return true if found, false if failed
+     */
+    bool get(const std::string &key, char *value)
+    {
+        const Value *stored = find(key);
+
+        if (stored == NULL) return (false);
+        convert(*stored, value);
+        return (true);
+    }
+
+    /*!
+     * @brief Get pair values from configuration
+     * @param key : The key identifying wanted value
+     * @param pair : The pair to fill with values
+     * @return true if found, false if failed
+     */
+    template<typename Tx, typename Ty>
+    bool getPair(const std::string &key,  std::pair<Tx, Ty> &pair)
+    {
+        const Value *stored = find(key);
+
+        if (stored == NULL) return (false);
+        return (convertPair(*stored, pair));
+    }
+
+    /*!
+     * @brief Used to get container-values from configuration
+     * @param key : The key identifying wanted container of values
+     * @param container : The container where the container of values will be pushed
+	 * @return true on success, false on failure.
+     */
+    template <typename T>
+    bool getContainer(const std::string &key, T &container)
+    {
+        const Value *stored = find(key);
+
+        if (stored == NULL) return (false);
+        convertContainer(*stored, container);
+        return (true);
+    }
+
+    /*!
+     * @brief Get a view over the numbers of a multi-value key, without copying them.
+     * Values stored by setContainer() are viewed in place, other values are converted into numbers owned by the view,
+     * so the configuration is never modified and concurrent readers stay safe.
+     * @param key : The key identifying wanted container of values
+     * @param view : The view to set
+     * @return true if found, false if failed
+     */
+    template <typename T>
+    bool getView(const std::string &key, PackedView<T> &view) const
+    {
+        static_assert(packable<T>::value, "only arithmetic types can be packed");
+        const Value *stored = find(key);
+
+        if (stored == NULL) return (false);
+        if (stored->elements<T>() == NULL) //Read from a file, or packed as another type
+        {
+            std::vector<T> elements;
+
+            convertContainer(*stored, elements);
+            view = PackedView<T>(Value::pack<T>(elements.begin(), elements.end(), &format<T>, stored));
+            return (true);
+        }
+        view = PackedView<T>(*stored);
+        return (true);
+    }
+
+    //
+    // ITERATION
+    //
+
+    /*!
+     * @class entry
+     * @brief Key visited by an iteration, referencing the configuration without copying it
+     */
+    class entry
+    {
+    public:
+        /*!
+         * @brief Get the section of the key
+         * @return The name of the section, empty for keys outside of sections
+         */
+        const std::string &section() const
+        {
+            return (_section->first);
+        }
+
+        /*!
+         * @brief Get the key, relative to its section
+         * @return The key
+         */
+        const std::string &key() const
+        {
+            return (_key->first);
+        }
+
+        /*!
+         * @brief Build the full key, as given to get()
+         * @return The full key
+         */
+        std::string name() const
+        {
+            return (join(_section->first, _key->first));
+        }
+
+        /*!
+         * @brief Get the value of the key
+         * @return The value
+         */
+        const Value &value() const
+        {
+            return (_key->second);
+        }
+
+        /*!
+         * @brief Convert the value of the key
+         * @param value : The variable to set with value
+         */
+        template <typename T>
+        void get(T &value) const
+        {
+            convert(_key->second, value);
+        }
+
+    protected:
+        friend class BasicConfig;
+        friend class const_iterator;
+
+        section_map::const_iterator _section;
+        association_map::const_iterator _key;
+    };
+
+    /*!
+     * @class const_iterator
+     * @brief Forward iterator over the keys of a configuration, ordered by section then by key
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef entry value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const entry *pointer;
+        typedef const entry &reference;
+
+        const_iterator() {}
+
+        reference operator*() const
+        {
+            return (_entry);
+        }
+
+        pointer operator->() const
+        {
+            return (&_entry);
+        }
+
+        const_iterator &operator++()
+        {
+            _entry._key++;
+            normalize(_entry);
+            if (equals(_entry, _gap)) _entry = _resume;
+            return (*this);
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator it = *this;
+
+            ++(*this);
+            return (it);
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return (equals(_entry, other._entry));
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return (!equals(_entry, other._entry));
+        }
+
+    protected:
+        friend class BasicConfig;
+
+        /*!
+         * @brief Iterator constructor
+         * @param last : The end of the sections iterated
+         * @param at : The first key visited
+         * @param gap : The position where the keys stop matching, first position skipped
+         * @param resume : The position where the keys match again
+         */
+        const_iterator(section_map::const_iterator last, const entry &at, const entry &gap, const entry &resume)
+         : _entry(at), _gap(gap), _resume(resume), _last(last)
+        {
+            normalize(_entry);
+            normalize(_gap);
+            normalize(_resume);
+            if (equals(_entry, _gap)) _entry = _resume;
+        }
+
+        /*!
+         * @brief Move a position past the end of a section to the beginning of the next one
+         * @param position : The position to move
+         */
+        void normalize(entry &position) const
+        {
+            while (position._section != _last && position._key == position._section->second->end())
+            {
+                if (++position._section != _last) position._key = position._section->second->begin();
+            }
+        }
+
+        bool equals(const entry &a, const entry &b) const
+        {
+            return (a._section == b._section && (a._section == _last || a._key == b._key));
+        }
+
+        entry _entry;
+        entry _gap;
+        entry _resume;
+        section_map::const_iterator _last;
+    };
+
+    /*!
+     * @class key_range
+     * @brief Lazy range of keys, sharing the storage of the configuration as it was when the range was taken
+     */
+    class key_range
+    {
+    public:
+        const_iterator begin() const
+        {
+            return (_begin);
+        }
+
+        const_iterator end() const
+        {
+            return (_end);
+        }
+
+        bool empty() const
+        {
+            return (_begin == _end);
+        }
+
+    protected:
+        friend class BasicConfig;
+
+        std::shared_ptr<const section_map> _config;
+        const_iterator _begin;
+        const_iterator _end;
+    };
+
+    /*!
+     * @brief Get every key of the configuration
+     * @return The range of keys, ordered by section then by key
+     */
+    key_range keys() const
+    {
+        std::shared_ptr<const section_map> config = view();
+
+        return (span(config, locate(*config, config->begin()), locate(*config, config->end())));
+    }
+
+    /*!
+     * @brief Get the keys starting with a given prefix, "Section:" for every key of a section
+     * @param prefix : The beginning of the full keys wanted
+     * @return The range of keys, ordered by section then by key
+     */
+    key_range prefix(const std::string &prefix) const
+    {
+        std::shared_ptr<const section_map> config = view();
+        size_t sep = separator(prefix);
+
+        if (sep != std::string::npos) //Keys of a single section
+        {
+            std::string section = prefix.substr(0, sep), key = prefix.substr(sep + section_field::size()), upper = successor(key);
+            entry to = (upper.empty() ? locate(*config, config->upper_bound(section)) : locate(*config, section, upper));
+
+            return (span(config, locate(*config, section, key), to));
+        }
+        else //Keys outside of sections, then every key of the sections starting with the prefix
+        {
+            std::string upper = successor(prefix);
+            entry to = (upper.empty() ? locate(*config, config->upper_bound(std::string())) : locate(*config, std::string(), upper));
+            entry resume = locate(*config, (prefix.empty() ? config->upper_bound(std::string()) : config->lower_bound(prefix)));
+            entry last = locate(*config, (upper.empty() ? config->end() : config->lower_bound(upper)));
+
+            return (span(config, locate(*config, std::string(), prefix), last, to, resume));
+        }
+    }
+
+    /*!
+     * @brief Get the keys from a given key (included) to another (excluded), ordered by section then by key
+     * @param from : The first full key wanted
+     * @param to : The full key where the range ends
+     * @return The range of keys
+     */
+    key_range between(const std::string &from, const std::string &to) const
+    {
+        std::shared_ptr<const section_map> config = view();
+        size_t begin = separator(from), end = separator(to);
+        association lower = (begin == std::string::npos ? association(std::string(), from) : association(from.substr(0, begin), from.substr(begin + section_field::size())));
+        association upper = (end == std::string::npos ? association(std::string(), to) : association(to.substr(0, end), to.substr(end + section_field::size())));
+        entry first = locate(*config, lower.first, lower.second);
+
+        if (!(lower < upper)) return (span(config, first, first));
+        return (span(config, first, locate(*config, upper.first, upper.second)));
+    }
+
+    //
+    // SETTERS
+    //
+
+    /*!
+     * @brief Set configuration values with arithmetic types.
+     * @param key : The key indentifier to set
+     * @param value : The primitive-typed value to set in key field
+     */
+    template <typename T>
+    void set(const std::string &key, const T &value)
+    {
+        set(key, stringify(value));
+    }
+
+    /*!
+     * @brief Set configuration values with string types.
+     * Values referencing other keys or environment variables (${Section:Key}, ${VAR}) are expanded once here,
+     * and expanded again only when one of their references is modified.
+     * @param key : The key indentifier to set
+     * @param value : The string value to set in key field
+     */
+    void set(const std::string &key, const std::string &value)
+    {
+        writable();
+        if (interpolated(value))
+        {
+            bind(key, value);
+        }
+        else
+        {
+            if (!templates().empty()) unbind(key);
+            store(key, value);
+        }
+        if (!dependencies().empty()) refresh(key);
+    }
+
+    /*!
+     * @brief Set a configuration value already built
+     * @param key : The key indentifier to set
+     * @param value : The value to set in key field
+     */
+    void set(const std::string &key, const Value &value)
+    {
+        writable();
+        if (!templates().empty()) unbind(key);
+        store(key, value);
+        if (!dependencies().empty()) refresh(key);
+    }
+
+    /*!
+     * @brief Set configuration values with bool types.
+     * @param key : The key indentifier to set
+     * @param value : The bool-typed value to set in key field
+     */
+    void set(const std::string key, const bool &value)
+    {
+        set(key, (value ? "true" : "false"));
+    }
+
+    /*!
+     * @brief Set configuration values with the contents of an std::pair.
+     * @param key : The key indentifier to set
+     * @param pair : The pair with values to fill in key field
+     */
+    template<typename Tx, typename Ty>
+    void setPair(const std::string &key, const std::pair<Tx, Ty> &pair)
+    {
+        set(key, stringify(pair.first) + Grammar::valueFieldSeparator() + stringify(pair.second));
+    }
+
+    /*!
+     * @brief Set configuration values with the contents of any stl container implementing const_iterator.
+     * Numbers are kept packed in memory, their text is only built when saved or read as text.
+     * @param key : The key indentifier to set
+     * @param container : The container with values to fill in key field
+     */
+    template <typename T>
+    void setContainer(const std::string &key, const T &container)
+    {
+        setContainer(key, container, packable<typename T::value_type>());
+    }
+
+    //
+    // MODIFIERS
+    //
+
+    /*!
+     * @brief Used to rename configuration key
+     * @param srcKey : The source key containing the value to copy
+     * @param destKey : The destination key fill with source value
+     */
+    void move(const std::string &srcKey, const std::string &destKey)
+    {
+        if (exists(srcKey))
+        {
+            uint64_t batch = _batch;
+
+            _batch = (batch != 0 ? batch : tick()); //Both keys change under a single version
+            try {
+                copy(srcKey, destKey);
+                erase(srcKey);
+            }
+            catch (...)
+            {
+                _batch = batch;
+                throw;
+            }
+            _batch = batch;
+        }
+        else
+        {
+            throw (std::runtime_error("undefined key: "+srcKey)); //No source to move from !
+        }
+    }
+
+
+
+    /*!
+     * @brief Used to copy configuration value into another
+     * @param srcKey : The source key containing the value to copy
+     * @param destKey : The destination key fill with source value
+     */
+    void copy(const std::string &srcKey, const std::string &destKey)
+    {
+        if (exists(srcKey))
+        {
+            set(destKey, raw(srcKey));
+        }
+        else
+        {
+            throw (std::runtime_error("undefined key: "+srcKey)); //No source to move from !
+        }
+    }
+
+    //
+    // TRANSACTIONS
+    //
+
+    /*!
+     * @brief Begin a batch of modifications, made visible all at once by commit()
+     * Modifying the configuration itself before commit() makes the commit fail.
+     * @return The transaction
+     */
+    BasicTransaction<Grammar> begin()
+    {
+        writable();
+        return (BasicTransaction<Grammar>(*this));
+    }
+
+    /*!
+     * @brief Erase a key from configuration
+     * @param key : The key to erase
+     */
+    void erase(const std::string &key)
+    {
+        writable();
+        size_t sep = separator(key);
+        std::string name = (sep == std::string::npos ? std::string() : key.substr(0, sep));
+        std::string relative = (sep == std::string::npos ? key : key.substr(sep + section_field::size()));
+        section_map::const_iterator section = sections().find(name);
+
+        if (section != sections().end() && section->second->count(relative) > 0)
+        {
+            association_map &keys = detach(name);
+
+            keys.erase(relative);
+            if (keys.empty()) detach().erase(name);
+            touch();
+            if (!templates().empty()) unbind(key);
+            if (!dependencies().empty()) refresh(key);
+        }
+        else
+        {
+            throw (std::runtime_error("undefined key:"+key)); //No key to erase !
+        }
+    }
+
+    //
+    // MEMORY
+    //
+
+    /*!
+     * @brief Enable or disable value interning: identical values set afterwards share the same memory
+     * Call compact() to share the values that were stored before interning was enabled.
+     * @param enable : true to share identical values
+     */
+    void setInterning(bool enable)
+    {
+        _interning = enable;
+        if (!enable) _pool.reset();
+    }
+
+    /*!
+     * @brief Enable or disable file mapping: files loaded afterwards are mapped in memory, and values reference the mapping
+     * Values are only copied when modified, or when quotes, escapes or references need them parsed.
+     * The file is replaced instead of being rewritten on save, so that the mapping stays valid,
+     * but it must not be truncated by anyone else while values reference it.
+     * Disabling it copies the values still referencing a mapping.
+     * @param enable : true to map files on load
+     */
+    void setMapping(bool enable)
+    {
+        if (_mapping && !enable) unmap();
+        _mapping = enable;
+    }
+
+    /*!
+     * @brief Rebuild storage densely, releasing memory left by removed or modified keys.
+     * When interning is enabled, every identical value is shared.
+     */
+    void compact()
+    {
+        writable();
+        {
+            std::shared_ptr<section_map> config = std::make_shared<section_map>();
+
+            for (typename section_map::const_iterator section = sections().begin(); section != sections().end(); section++)
+            {
+                association_map &keys = detach(*config, section->first);
+
+                for (association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+                {
+                    Value value = (_interning && !it->second.packed() ? intern(it->second) : it->second);
+
+                    value._version = it->second._version; //Same content, same version
+                    keys.insert(keys.end(), typename association_map::value_type(it->first, value));
+                }
+            }
+            _config = config;
+        }
+        if (!_pool) return;
+        value_pool &pooled = own(_pool);
+
+        for (value_pool::iterator it = pooled.begin(); it != pooled.end();)
+        {
+            if (it->shares() == 1) it = pooled.erase(it); //Only referenced by the pool
+            else it++;
+        }
+        pooled.rehash(0);
+    }
+
+    /*!
+     * @brief Report the memory used by the configuration
+     * @return The report, see stb::MemoryReport
+     */
+    MemoryReport memoryUsage() const
+    {
+        const size_t node = 4 * sizeof(void *); //Tree node links and color
+        MemoryReport report = MemoryReport();
+        std::set<const void *> counted;
+
+        report.sections = sections().size();
+        for (typename section_map::const_iterator section = sections().begin(); section != sections().end(); section++)
+        {
+            report.keyBytes += section->first.size();
+            report.total += node + sizeof(typename section_map::value_type) + allocated(section->first) + sizeof(association_map);
+            for (association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                report.keys++;
+                report.keyBytes += it->first.size();
+                report.total += node + sizeof(association_map::value_type) + allocated(it->first);
+                if (it->second.storage() == NULL || counted.insert(it->second.storage()).second)
+                {
+                    report.values++;
+                    report.valueBytes += it->second.bytes();
+                    report.total += it->second.allocated();
+                }
+                else
+                {
+                    report.sharedBytes += it->second.bytes();
+                }
+            }
+        }
+        report.total += pool().bucket_count() * sizeof(void *) + pool().size() * (sizeof(Value) + 2 * sizeof(void *));
+        if (_frozen)
+        {
+            const char *section = NULL;
+            size_t length = 0;
+
+            for (size_t i = 0; i < _frozen->order.size(); i++)
+            {
+                const typename frozen_table::slot &slot = _frozen->slots[_frozen->order[i].first];
+
+                if (section == NULL || length != _frozen->order[i].second || memcmp(section, slot.key, length) != 0) report.sections++;
+                section = slot.key;
+                length = _frozen->order[i].second;
+                report.keys++;
+                report.keyBytes += slot.keySize;
+                if (!slot.value.packed() || counted.insert(slot.value.storage()).second)
+                {
+                    report.values++;
+                    report.valueBytes += slot.value.bytes();
+                    if (slot.value.packed()) report.total += slot.value.allocated(); //Text values are in the block
+                }
+            }
+            report.total += sizeof(frozen_table) + _frozen->block.allocated() + _frozen->slots.capacity() * sizeof(typename frozen_table::slot)
+                          + _frozen->displacements.capacity() * sizeof(uint32_t)
+                          + _frozen->order.capacity() * sizeof(std::pair<size_t, size_t>)
+                          + _frozen->sources.capacity() * sizeof(std::pair<size_t, Value>);
+        }
+        return (report);
+    }
+
+    //
+    // FREEZE
+    //
+
+    /*!
+     * @brief Make the configuration read-only, and index every key with a minimal perfect hash.
+     * Keys and values are moved into a single block, so that get() and exists() cost a single probe,
+     * and the sections are released. Any modification is rejected until thaw() is called,
+     * concurrent reads need no synchronization.
+     */
+    void freeze()
+    {
+        if (_frozen) return;
+        std::shared_ptr<frozen_table> table = std::make_shared<frozen_table>();
+        std::vector<typename frozen_table::slot> entries;
+        std::vector<std::vector<size_t> > buckets;
+        std::vector<size_t> order, positions;
+        std::vector<bool> taken;
+        size_t bytes = 0;
+        char *cursor;
+
+        for (section_map::const_iterator section = sections().begin(); section != sections().end(); section++)
+        {
+            for (association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                bytes += join(section->first, it->first).size() + (it->second.packed() ? 0 : it->second.size());
+            }
+        }
+        for (template_map::const_iterator it = templates().begin(); it != templates().end(); it++)
+        {
+            bytes += it->second.size();
+        }
+        table->block = Value::reserve(bytes);
+        cursor = const_cast<char *>(table->block.data()); //Not shared until the table is built
+        for (section_map::const_iterator section = sections().begin(); section != sections().end(); section++)
+        {
+            for (association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                std::string key = join(section->first, it->first);
+                template_map::const_iterator source = templates().find(key);
+                typename frozen_table::slot slot;
+
+                slot.hash = Value::hash(key.data(), key.size());
+                slot.key = cursor;
+                slot.keySize = key.size();
+                cursor = std::copy(key.begin(), key.end(), cursor);
+                if (it->second.packed()) slot.value = it->second; //Numbers stay packed
+                else
+                {
+                    slot.value = table->block.slice(cursor - table->block.data(), it->second.size());
+                    slot.value._version = it->second._version;
+                    cursor = std::copy(it->second.data(), it->second.data() + it->second.size(), cursor);
+                }
+                if (source != templates().end()) //Kept unexpanded, to be saved and bound again once thawed
+                {
+                    table->sources.push_back(std::make_pair(entries.size(), table->block.slice(cursor - table->block.data(), source->second.size())));
+                    cursor = std::copy(source->second.begin(), source->second.end(), cursor);
+                }
+                table->order.push_back(std::make_pair(entries.size(), section->first.size()));
+                entries.push_back(slot);
+            }
+        }
+        table->displacements.assign((entries.size() + 1) / 2, 0);
+        buckets.resize(table->displacements.size());
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            buckets[entries[i].hash % buckets.size()].push_back(i);
+        }
+        for (size_t i = 0; i < buckets.size(); i++) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) { return (buckets[a].size() > buckets[b].size()); });
+        positions.resize(entries.size());
+        taken.assign(entries.size(), false);
+        for (size_t i = 0; i < order.size() && !buckets[order[i]].empty(); i++) //Place the largest buckets first
+        {
+            const std::vector<size_t> &bucket = buckets[order[i]];
+            uint32_t displacement = 0;
+
+            for (size_t j = 0; j < bucket.size(); j++)
+            {
+                for (size_t k = j + 1; k < bucket.size(); k++)
+                {
+                    if (entries[bucket[j]].hash == entries[bucket[k]].hash) throw (std::runtime_error("unable to freeze configuration")); //Same hash, never separable
+                }
+            }
+            for (;; displacement++)
+            {
+                size_t placed = 0;
+
+                if (displacement == std::numeric_limits<uint32_t>::max()) throw (std::runtime_error("unable to freeze configuration"));
+                for (; placed < bucket.size(); placed++)
+                {
+                    size_t position = frozen_table::position(entries[bucket[placed]].hash, displacement, entries.size());
+
+                    if (taken[position]) break;
+                    taken[position] = true;
+                    positions[bucket[placed]] = position;
+                }
+                if (placed == bucket.size()) break;
+                while (placed-- > 0) taken[positions[bucket[placed]]] = false; //Collision, try the next displacement
+            }
+            table->displacements[order[i]] = displacement;
+        }
+        table->slots.resize(entries.size());
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            table->slots[positions[i]] = entries[i];
+            table->order[i].first = positions[i];
+        }
+        for (size_t i = 0; i < table->sources.size(); i++)
+        {
+            table->sources[i].first = positions[table->sources[i].first];
+        }
+        std::sort(table->sources.begin(), table->sources.end(), [](const std::pair<size_t, Value> &a, const std::pair<size_t, Value> &b) { return (a.first < b.first); });
+        _frozen = table;
+        _config.reset(); //Everything is held by the table
+        _templates.reset();
+        _dependents.reset();
+        _pool.reset();
+    }
+
+    /*!
+     * @brief Make a frozen configuration modifiable again, rebuilding its sections and references from the table
+     */
+    void thaw()
+    {
+        if (!_frozen) return;
+        std::shared_ptr<const frozen_table> table = _frozen;
+
+        _frozen.reset();
+        _config = rebuild(*table, false);
+        for (section_map::iterator section = _config->begin(); section != _config->end(); section++)
+        {
+            for (association_map::iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                if (it->second.packed()) continue;
+                Value owned = make(it->second.str()); //Releases the block once every view of it is gone
+
+                owned._version = it->second._version;
+                it->second = owned;
+            }
+        }
+        for (size_t i = 0; i < table->sources.size(); i++)
+        {
+            const typename frozen_table::slot &slot = table->slots[table->sources[i].first];
+            std::string key(slot.key, slot.keySize);
+            std::vector<std::string> names = references(table->sources[i].second.str());
+
+            own(_templates)[key] = table->sources[i].second.str();
+            for (size_t j = 0; j < names.size(); j++)
+            {
+                own(_dependents)[names[j]].insert(key);
+            }
+        }
+    }
+
+    /*!
+     * @brief Tests if the configuration is frozen
+     * @return true if frozen, false if modifiable
+     */
+    bool frozen() const
+    {
+        return (_frozen != NULL);
+    }
+
+    //
+    // VALIDATION
+    //
+
+    /*!
+     * @brief Check every association against a schema while it is loaded, in the same pass
+     * Values of the types expected are converted once and stored, get() then reads them without parsing.
+     * @param schema : The schema to check against, copied
+     */
+    template <typename Schema>
+    void setSchema(const Schema &schema)
+    {
+        _schema = std::make_shared<Schema>(schema);
+        _persisted = file_state(); //Loading again converts and checks values
+        _pending.reset();
+    }
+
+    /*!
+     * @brief Stop checking associations while they are loaded
+     */
+    void clearSchema()
+    {
+        _schema.reset();
+        _persisted = file_state();
+        _pending.reset();
+    }
+
+    /*!
+     * @brief Get the errors found by the schema during the last load
+     * @return The errors, in order of appearance
+     */
+    const std::vector<ValidationError> &errors() const
+    {
+        return (_errors);
+    }
+
+    //
+    // DEFAULTS
+    //
+
+    /*!
+     * @brief Use an embedded configuration as the base layer of this one (see TINYCONF_EMBED)
+     * Keys missing from this configuration are looked up in the embedded table, parsed at compile time:
+     * defaults cost neither parsing nor allocation, and are never saved nor iterated.
+     * @tparam Defaults : The embedded configuration type
+     */
+    template <typename Defaults>
+    void setDefaults()
+    {
+        static_assert(std::is_same<typename Defaults::grammar, Grammar>::value, "defaults must share the grammar of the configuration");
+        _defaults = &Defaults::find;
+    }
+
+    /*!
+     * @brief Stop falling back on embedded defaults
+     */
+    void clearDefaults()
+    {
+        _defaults = NULL;
+    }
+
+    //
+    // LOAD / SAVE
+    //
+
+    /*!
+     * @brief Load config stored in the associated file.
+     * @return true on success, false on failure or if the schema found errors.
+     */
+    bool load()
+    {
+        _errors.clear();
+        if (_mapping) return (loadMapped());
+        file_state state = inspect(_path); //Before reading, so that later writes are noticed
+        bool merged = !empty(); //Keys set before are not in the file
+		std::vector<std::string> buffer = dump();
+        std::string section, current;
+        association pair;
+        association_map *target = NULL;
+        bool comment = false;
+        uint64_t version = touch(); //Every key loaded shares a version
+
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            if (formatBuffer(buffer[i], section, comment))
+            {
+                pair = parseBuffer(buffer[i]);
+                if (interpolated(pair.second) || !templates().empty() || !dependencies().empty())
+                {
+                    assign(section, pair, i + 1);
+                    continue;
+                }
+                if (target == NULL || section != current) //Section is resolved once, keys are stored relative to it
+                {
+                    target = &detach(section);
+                    current = section;
+                }
+                Value &stored = (*target)[pair.first];
+
+                stored = make(pair.second);
+                if (_schema) _schema->check(section, pair.first, stored, i + 1, _errors);
+                stored._version = version;
+            }
+        }
+        if (_schema) _schema->complete(*this, _errors);
+        record(state, digest(buffer), merged);
+        return (_errors.empty());
+    }
+
+    /*!
+     * @brief Save current config state inside associated file, nothing is written if neither the file nor the configuration changed since
+     */
+    void save()
+    {
+        if (!modified() && _persisted.exists && !stale()) return; //File already holds the configuration
+        std::shared_ptr<const section_map> config = snapshot();
+        uint64_t written = write(_path, *config);
+
+        record(inspect(_path), written);
+    }
+
+    //
+    // CHANGE DETECTION
+    //
+
+    /*!
+     * @brief Tests if the configuration changed since it was last loaded or saved.
+     * Keys set to the values they already had, or set then restored, do not count as changes.
+     * @return true if changed, or if the associated file was neither loaded nor saved
+     */
+    bool modified()
+    {
+        settle();
+        if (!_persisted.known || _persisted.path != _path || _persisted.merged) return (true);
+        if (_epoch == _persisted.epoch) return (false); //Untouched since
+        if (fingerprint(*snapshot()) != _persisted.content) return (true);
+        _persisted.epoch = _epoch; //Same contents, no need to hash them again
+        return (false);
+    }
+
+    /*!
+     * @brief Tests if the associated file changed since it was last loaded or saved.
+     * Size, timestamp and identity of the file are compared, its contents are hashed only when written too recently for the timestamp to tell.
+     * @return true if changed, or if the associated file was neither loaded nor saved
+     */
+    bool stale()
+    {
+        settle();
+        if (!_persisted.known || _persisted.path != _path) return (true);
+        file_state current = inspect(_path);
+
+        if (!same(current, _persisted)) return (true);
+        if (_persisted.racy && current.exists && digest(dump(_path)) != _persisted.digest) return (true);
+        _persisted.racy = current.racy; //Once old enough, the timestamp alone tells
+        return (false);
+    }
+
+    //
+    // ASYNCHRONOUS LOAD / SAVE
+    //
+
+    /*!
+     * @brief Load config stored in the associated file, on the background I/O thread.
+     * The configuration must not be accessed until the operation completes.
+     * @return A future holding the result of load()
+     */
+    std::future<bool> loadAsync()
+    {
+        return (async(std::function<bool()>([this]() { return (load()); })));
+    }
+
+    /*!
+     * @brief Load config stored in the associated file, on the background I/O thread.
+     * The configuration must not be accessed until the operation completes.
+     * @param callback : The callback to notify on completion, from the I/O thread
+     */
+    void loadAsync(const completion &callback)
+    {
+        async([this]() { load(); }, callback);
+    }
+
+    /*!
+     * @brief Reload configuration from associated file, on the background I/O thread.
+     * The configuration must not be accessed until the operation completes.
+     * @return A future notified on completion
+     */
+    std::future<void> reloadAsync()
+    {
+        return (async(std::function<void()>([this]() { reload(); })));
+    }
+
+    /*!
+     * @brief Reload configuration from associated file, on the background I/O thread.
+     * The configuration must not be accessed until the operation completes.
+     * @param callback : The callback to notify on completion, from the I/O thread
+     */
+    void reloadAsync(const completion &callback)
+    {
+        async([this]() { reload(); }, callback);
+    }
+
+    /*!
+     * @brief Save current config state inside associated file, on the background I/O thread.
+     * The state is captured on call, so the configuration can be modified while it is written.
+     * @return A future notified on completion
+     */
+    std::future<void> saveAsync()
+    {
+        return (async(writer()));
+    }
+
+    /*!
+     * @brief Save current config state inside associated file, on the background I/O thread.
+     * The state is captured on call, so the configuration can be modified while it is written.
+     * @param callback : The callback to notify on completion, from the I/O thread
+     */
+    void saveAsync(const completion &callback)
+    {
+        async(writer(), callback);
+    }
+
+    //
+    // INTEROPERABILITY
+    //
+
+    /*!
+     * @brief Copies a given key to another configuration
+     * @param key : The key to copy
+     * @param target : The target configuration to copy to
+     */
+    void copyTo(const std::string &key, BasicConfig &target)
+    {
+        if (exists(key))
+        {
+            target.set(key, raw(key));
+        }
+        else
+        {
+            throw (std::runtime_error("undefined key: "+key)); //No key to copy !
+        }
+    }
+
+    /*!
+     * @brief Moves a given key to another configuration (removes key from caller)
+     * @param key : The key to move
+     * @param target : The target configuration to move to
+     */
+    void moveTo(const std::string &key, BasicConfig &target)
+    {
+        try {
+            copyTo(key, target);
+        }
+        catch(...)
+        {
+            return; //Failed! do not erase
+        }
+        erase(key);
+    }
+
+    /*!
+     * @brief Append the target configuration to the caller
+     * @param source : The configuration to copy keys from
+     */
+    void append(const BasicConfig &source)
+    {
+        writable();
+        if (empty() && templates().empty() && !source._frozen && source.templates().empty() && dependencies().empty() && !_interning)
+        {
+            _config = source._config; //Nothing to merge with, share the source storage
+            touch();
+            return;
+        }
+        std::shared_ptr<const section_map> config = source.view();
+
+        for (section_map::const_iterator section = config->begin(); section != config->end(); section++)
+        {
+            for (association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                std::string key = join(section->first, it->first);
+
+                set(key, source.raw(key));
+            }
+        }
+    }
+
+    /*!
+     * @brief Append the configuration file to the caller
+     * @param path : The path to the configuration file to copy keys from
+     */
+    void append(const std::string &path)
+    {
+        append(BasicConfig(path));
+    }
+
+protected:
+    template <typename> friend class BasicConfigStack;
+    template <typename> friend class BasicConfigPublisher;
+    template <typename> friend class BasicSharedConfig;
+    template <typename, typename> friend class BasicBinding;
+    template <typename> friend class BasicPatch;
+    template <typename> friend class BasicTransaction;
+    template <typename> friend class BasicSchema;
+
+    //
+    // GRAMMAR
+    //
+
+    typedef syntax::CharClass<syntax::CommentLine<Grammar> > comment_line;
+    typedef syntax::CharClass<syntax::StringIdentifiers<Grammar> > string_identifiers;
+    typedef syntax::Token<syntax::CommentBegin<Grammar> > comment_begin;
+    typedef syntax::Token<syntax::CommentEnd<Grammar> > comment_end;
+    typedef syntax::Token<syntax::SectionField<Grammar> > section_field;
+    typedef syntax::Token<syntax::SectionBegin<Grammar> > section_begin;
+    typedef syntax::Token<syntax::SectionEnd<Grammar> > section_end;
+    typedef syntax::Token<syntax::KeyValue<Grammar> > key_value;
+    typedef syntax::Token<syntax::ValueField<Grammar> > value_field;
+    typedef syntax::Token<syntax::InterpolationBegin<Grammar> > interpolation_begin;
+    typedef syntax::Token<syntax::InterpolationEnd<Grammar> > interpolation_end;
+
+    /*! @brief Container used to store the values holding references, by full key */
+    typedef std::map<std::string, std::string> template_map;
+    /*! @brief Container used to store the keys referencing each key */
+    typedef std::map<std::string, std::set<std::string> > dependency_map;
+    /*! @brief Container used to share identical values */
+    typedef std::unordered_set<Value, Value::Hash> value_pool;
+
+    /*! @brief Keys and values of a frozen configuration, indexed by a minimal perfect hash */
+    struct frozen_table
+    {
+        /*! @brief Key of the table, referencing the block */
+        struct slot
+        {
+            uint64_t hash;
+            const char *key;
+            size_t keySize;
+            Value value;
+        };
+
+        /*!
+         * @brief Get the slot of a key
+         * @param hash : The hash of the key
+         * @param displacement : The displacement of the bucket of the key
+         * @param count : The number of slots
+         * @return The slot where the key may be
+         */
+        static size_t position(uint64_t hash, uint32_t displacement, size_t count)
+        {
+            uint64_t mixed = hash ^ (displacement * 0x9E3779B97F4A7C15ULL);
+
+            mixed = (mixed ^ (mixed >> 33)) * 0xFF51AFD7ED558CCDULL;
+            return (static_cast<size_t>((mixed ^ (mixed >> 33)) % count));
+        }
+
+        /*!
+         * @brief Find the slot of a key with a single probe
+         * @param key : The full key
+         * @return The index of the slot, npos if undefined
+         */
+        size_t index(const std::string &key) const
+        {
+            if (slots.empty()) return (std::string::npos);
+            uint64_t hash = Value::hash(key.data(), key.size());
+            size_t found = position(hash, displacements[hash % displacements.size()], slots.size());
+            const slot &candidate = slots[found];
+
+            if (candidate.hash != hash || candidate.keySize != key.size() || memcmp(candidate.key, key.data(), key.size()) != 0) return (std::string::npos);
+            return (found);
+        }
+
+        /*!
+         * @brief Find the value of a key with a single probe
+         * @param key : The full key
+         * @return A pointer to the value, NULL if undefined
+         */
+        const Value *find(const std::string &key) const
+        {
+            size_t found = index(key);
+
+            return (found == std::string::npos ? NULL : &slots[found].value);
+        }
+
+        /*!
+         * @brief Get the value of a slot as it was set, with its references unexpanded
+         * @param index : The index of the slot
+         * @return A pointer to the value, NULL if the value holds no references
+         */
+        const Value *source(size_t index) const
+        {
+            typename std::vector<std::pair<size_t, Value> >::const_iterator it;
+
+            it = std::lower_bound(sources.begin(), sources.end(), index, [](const std::pair<size_t, Value> &source, size_t slot) { return (source.first < slot); });
+            return (it == sources.end() || it->first != index ? NULL : &it->second);
+        }
+
+        /*! @brief Characters of the keys, values and unexpanded values, referenced by the slots */
+        Value block;
+        std::vector<slot> slots;
+        std::vector<uint32_t> displacements;
+        /*! @brief Slot of each key in the order of the sections, with the size of the section prefixing the key */
+        std::vector<std::pair<size_t, size_t> > order;
+        /*! @brief Unexpanded values of the keys holding references, by slot */
+        std::vector<std::pair<size_t, Value> > sources;
+    };
+
+    /*!
+     * @brief Run an operation on the background I/O thread
+     * @param operation : The operation to run
+     * @return A future holding the result of the operation
+     */
+    template <typename R>
+    static std::future<R> async(const std::function<R()> &operation)
+    {
+        std::shared_ptr<std::packaged_task<R()> > task = std::make_shared<std::packaged_task<R()> >(operation);
+        std::future<R> result = task->get_future();
+
+        IOWorker::instance().post([task]() { (*task)(); });
+        return (result);
+    }
+
+    /*!
+     * @brief Run an operation on the background I/O thread
+     * @param operation : The operation to run
+     * @param callback : The callback to notify on completion
+     */
+    static void async(const std::function<void()> &operation, const completion &callback)
+    {
+        IOWorker::instance().post([operation, callback]() {
+            std::exception_ptr error;
+
+            try {
+                operation();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            if (callback) callback(error);
+        });
+    }
+
+    //
+    // STORAGE
+    //
+
+    /*!
+     * @brief Find the separator between the section and the key
+     * @param key : The full key
+     * @return The position of the separator, npos for keys without section
+     */
+    static size_t separator(const std::string &key)
+    {
+        for (size_t cursor = section_field::find(key); cursor != std::string::npos; cursor = section_field::find(key, cursor + 1))
+        {
+            if (cursor == 0 || key[cursor - 1] != Grammar::escapeCharacter()) return (cursor); //check for non escaped sequence
+        }
+        return (std::string::npos);
+    }
+
+    /*!
+     * @brief Build the full key of a key relative to a section
+     * @param section : The section, empty for none
+     * @param key : The key relative to the section
+     * @return The full key
+     */
+    static std::string join(const std::string &section, const std::string &key)
+    {
+        if (section.empty()) return (key);
+        return (section + Grammar::sectionFieldSeparator() + key);
+    }
+
+    /*!
+     * @brief Get the sections stored in memory, for reading.
+     * A frozen configuration holds none, readers that may run while frozen use view() instead.
+     * @return The sections
+     */
+    const section_map &sections() const
+    {
+        static const section_map none;
+
+        return (_config ? *_config : none);
+    }
+
+    /*!
+     * @brief Reject modifications of a frozen configuration
+     */
+    void writable() const
+    {
+        if (_frozen) throw (std::runtime_error("frozen configuration")); //Call thaw() first !
+    }
+
+    /*!
+     * @brief Get the sections stored in memory for writing, cloning them first if they are shared with a copy
+     * @return The sections, owned by this configuration
+     */
+    section_map &detach()
+    {
+        writable();
+        if (!_config) _config = std::make_shared<section_map>();
+        else if (_config.use_count() != 1) _config = std::make_shared<section_map>(*_config);
+        return (*_config);
+    }
+
+    /*!
+     * @brief Get a section for writing, cloning it first if it is shared with a copy
+     * @param name : The name of the section, created if undefined
+     * @return The keys of the section, owned by this configuration
+     */
+    association_map &detach(const std::string &name)
+    {
+        return (detach(detach(), name));
+    }
+
+    /*!
+     * @brief Get a section of given sections for writing, cloning it first if it is shared
+     * @param config : The sections owning the section
+     * @param name : The name of the section, created if undefined
+     * @return The keys of the section
+     */
+    static association_map &detach(section_map &config, const std::string &name)
+    {
+        std::shared_ptr<association_map> &keys = config[name];
+
+        if (!keys) keys = std::make_shared<association_map>();
+        else if (keys.use_count() != 1) keys = std::make_shared<association_map>(*keys);
+        return (*keys);
+    }
+
+    /*!
+     * @brief Copy the values referencing a mapped file into storages of their own, so that the file can be rewritten
+     */
+    void unmap()
+    {
+        std::vector<std::string> names;
+
+        for (section_map::const_iterator section = sections().begin(); section != sections().end(); section++)
+        {
+            for (association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                if (it->second.mapped())
+                {
+                    names.push_back(section->first);
+                    break;
+                }
+            }
+        }
+        for (size_t i = 0; i < names.size(); i++) //Sections are detached once every section was walked
+        {
+            association_map &keys = detach(names[i]);
+
+            for (association_map::iterator it = keys.begin(); it != keys.end(); it++)
+            {
+                if (!it->second.mapped()) continue;
+                Value owned = make(it->second.str());
+
+                owned._version = it->second._version; //Same content, same version
+                it->second = owned;
+            }
+        }
+    }
+
+    /*!
+     * @brief Get the values holding references, for reading
+     * @return The unexpanded values, by full key
+     */
+    const template_map &templates() const
+    {
+        return (contents(_templates));
+    }
+
+    /*!
+     * @brief Get the keys referencing each key, for reading
+     * @return The referencing keys, by referenced key
+     */
+    const dependency_map &dependencies() const
+    {
+        return (contents(_dependents));
+    }
+
+    /*!
+     * @brief Get the pool of interned values, for reading
+     * @return The pooled values
+     */
+    const value_pool &pool() const
+    {
+        return (contents(_pool));
+    }
+
+    /*!
+     * @brief Get a container shared with copies of the configuration, for reading
+     * @param shared : The container, NULL when empty
+     * @return The container
+     */
+    template <typename Container>
+    static const Container &contents(const std::shared_ptr<Container> &shared)
+    {
+        static const Container none;
+
+        return (shared ? *shared : none);
+    }
+
+    /*!
+     * @brief Get a container shared with copies of the configuration for writing, cloning it first if it is shared, as detach() does for sections
+     * @param shared : The container, created if NULL
+     * @return The container, owned by this configuration
+     */
+    template <typename Container>
+    static Container &own(std::shared_ptr<Container> &shared)
+    {
+        if (!shared) shared = std::make_shared<Container>();
+        else if (shared.use_count() != 1) shared = std::make_shared<Container>(*shared);
+        return (*shared);
+    }
+
+    /*!
+     * @brief Get the sections stored in memory, shared to be iterated while the configuration changes.
+     * The sections of a frozen configuration are rebuilt from its table, sharing its block.
+     * @return The sections
+     */
+    std::shared_ptr<const section_map> view() const
+    {
+        if (_frozen) return (rebuild(*_frozen, false));
+        return (_config ? _config : std::make_shared<section_map>());
+    }
+
+    /*!
+     * @brief Rebuild the sections of a frozen configuration
+     * @param table : The table of the configuration
+     * @param unexpanded : true to get the values holding references as they were set
+     * @return The sections, whose values share the block of the table
+     */
+    static std::shared_ptr<section_map> rebuild(const frozen_table &table, bool unexpanded)
+    {
+        std::shared_ptr<section_map> config = std::make_shared<section_map>();
+        association_map *keys = NULL;
+        std::string section;
+
+        for (size_t i = 0; i < table.order.size(); i++)
+        {
+            const typename frozen_table::slot &slot = table.slots[table.order[i].first];
+            size_t length = table.order[i].second;
+            const Value *source = (unexpanded ? table.source(table.order[i].first) : NULL);
+            size_t offset = (length == 0 ? 0 : length + section_field::size());
+
+            if (keys == NULL || section.compare(0, std::string::npos, slot.key, length) != 0)
+            {
+                section.assign(slot.key, length);
+                keys = &detach(*config, section);
+            }
+            keys->insert(keys->end(), typename association_map::value_type(std::string(slot.key + offset, slot.keySize - offset), source == NULL ? slot.value : *source));
+        }
+        return (config);
+    }
+
+    /*!
+     * @brief Get the position of the first key of a section
+     * @param config : The sections
+     * @param section : The section
+     * @return The position
+     */
+    static entry locate(const section_map &config, section_map::const_iterator section)
+    {
+        entry position;
+
+        position._section = section;
+        if (section != config.end()) position._key = section->second->begin();
+        return (position);
+    }
+
+    /*!
+     * @brief Get the position of the first key following a given key, itself included
+     * @param config : The sections
+     * @param section : The section of the key
+     * @param key : The key, relative to its section
+     * @return The position
+     */
+    static entry locate(const section_map &config, const std::string &section, const std::string &key)
+    {
+        entry position = locate(config, config.lower_bound(section));
+
+        if (position._section != config.end() && position._section->first == section) position._key = position._section->second->lower_bound(key);
+        return (position);
+    }
+
+    /*!
+     * @brief Build a range of consecutive keys
+     * @param config : The sections iterated
+     * @param from : The first key visited
+     * @param to : The position where the range ends
+     * @return The range
+     */
+    static key_range span(const std::shared_ptr<const section_map> &config, const entry &from, const entry &to)
+    {
+        return (span(config, from, to, to, to));
+    }
+
+    /*!
+     * @brief Build a range of keys made of two runs of consecutive keys
+     * @param config : The sections iterated
+     * @param from : The first key visited
+     * @param to : The position where the range ends
+     * @param gap : The position where the first run ends
+     * @param resume : The position where the second run begins
+     * @return The range
+     */
+    static key_range span(const std::shared_ptr<const section_map> &config, const entry &from, const entry &to, const entry &gap, const entry &resume)
+    {
+        key_range range;
+
+        range._config = config;
+        range._begin = const_iterator(config->end(), from, gap, resume);
+        range._end = const_iterator(config->end(), to, to, to);
+        return (range);
+    }
+
+    /*!
+     * @brief Get the smallest string greater than every string starting with a prefix
+     * @param prefix : The prefix
+     * @return The bound, empty if there is none
+     */
+    static std::string successor(const std::string &prefix)
+    {
+        std::string bound = prefix;
+
+        while (!bound.empty() && static_cast<unsigned char>(bound[bound.size() - 1]) == 0xFF) bound.erase(bound.size() - 1);
+        if (!bound.empty()) bound[bound.size() - 1] = static_cast<char>(static_cast<unsigned char>(bound[bound.size() - 1]) + 1);
+        return (bound);
+    }
+
+    /*!
+     * @brief Find the value of a key in memory, then in the defaults
+     * @param key : The full key
+     * @return A pointer to the value, NULL if undefined
+     */
+    const Value *find(const std::string &key) const
+    {
+        const Value *value = lookup(key);
+
+        if (value == NULL && _defaults != NULL) return (_defaults(key));
+        return (value);
+    }
+
+    /*!
+     * @brief Find the value of a key in memory, defaults excluded
+     * @param key : The full key
+     * @return A pointer to the value, NULL if undefined
+     */
+    const Value *lookup(const std::string &key) const
+    {
+        if (_frozen) return (_frozen->find(key));
+        const section_map &config = sections();
+        size_t sep = separator(key);
+        section_map::const_iterator section;
+        association_map::const_iterator it;
+
+        if (sep == std::string::npos)
+        {
+            section = config.find(std::string());
+            if (section == config.end()) return (NULL);
+            it = section->second->find(key);
+        }
+        else
+        {
+            section = config.find(key.substr(0, sep));
+            if (section == config.end()) return (NULL);
+            it = section->second->find(key.substr(sep + section_field::size()));
+        }
+        if (it == section->second->end()) return (NULL);
+        return (&it->second);
+    }
+
+    /*!
+     * @brief Stores a value as is in memory
+     * @param key : The key indentifier to set
+     * @param value : The value to store
+     */
+    void store(const std::string &key, const std::string &value)
+    {
+        store(key, make(value));
+    }
+
+    /*!
+     * @brief Stores a value already built in memory
+     * @param key : The key indentifier to set
+     * @param value : The value to store
+     */
+    void store(const std::string &key, const Value &value)
+    {
+        store(key, value, touch());
+    }
+
+    /*!
+     * @brief Stores a value already built in memory, with a given version
+     * @param key : The key indentifier to set
+     * @param value : The value to store
+     * @param version : The version of the value
+     */
+    void store(const std::string &key, const Value &value, uint64_t version)
+    {
+        size_t sep = separator(key);
+        Value &stored = (sep == std::string::npos ? detach(std::string())[key] : detach(key.substr(0, sep))[key.substr(sep + section_field::size())]);
+
+        stored = value;
+        stored._version = version;
+    }
+
+    /*!
+     * @brief Start a new version of the configuration, or join the one of the open transaction
+     * @return The new version
+     */
+    uint64_t touch()
+    {
+        _epoch = (_batch != 0 ? _batch : tick()); //Every change of a transaction shares its version
+        return (_epoch);
+    }
+
+    /*!
+     * @brief Get a version from a clock shared by every configuration of the process
+     * @return The version, never returned before
+     */
+    static uint64_t tick()
+    {
+        static std::atomic<uint64_t> clock(0);
+
+        return (++clock);
+    }
+
+    /*!
+     * @brief Build a value to store, shared with identical values when interning is enabled
+     * @param text : The characters of the value
+     * @return The value
+     */
+    Value make(const std::string &text)
+    {
+        if (!_interning) return (Value(text));
+        value_pool::const_iterator it = pool().find(Value::borrow(text));
+        if (it != pool().end()) return (*it);
+        return (*own(_pool).insert(Value(text)).first);
+    }
+
+    /*!
+     * @brief Get the pooled value identical to a given one, pooling it if none
+     * @param value : The value to intern
+     * @return The pooled value
+     */
+    Value intern(const Value &value)
+    {
+        return (*own(_pool).insert(value).first);
+    }
+
+    /*!
+     * @brief Get the number of characters a string allocated outside of its own footprint
+     * @param str : The string
+     * @return The number of bytes allocated
+     */
+    static size_t allocated(const std::string &str)
+    {
+        return (str.capacity() + 1 > sizeof(std::string) ? str.capacity() + 1 : 0);
+    }
+
+    /*!
+     * @brief State of the configuration as it should be persisted, with references unexpanded.
+     * The state shares the storage of the configuration, so taking it costs no copy.
+     * @return The configuration state
+     */
+    std::shared_ptr<const section_map> snapshot() const
+    {
+        if (_frozen) return (rebuild(*_frozen, true));
+        if (templates().empty()) return (_config ? _config : std::make_shared<section_map>());
+        std::shared_ptr<section_map> config = std::make_shared<section_map>(sections());
+
+        for (template_map::const_iterator it = templates().begin(); it != templates().end(); it++)
+        {
+            size_t sep = separator(it->first);
+
+            if (sep == std::string::npos) detach(*config, std::string())[it->first] = Value(it->second); //Keep references unexpanded on disk
+            else detach(*config, it->first.substr(0, sep))[it->first.substr(sep + section_field::size())] = Value(it->second);
+        }
+        return (config);
+    }
+
+    /*!
+     * @brief Get the value of a key as it was set, with its references unexpanded
+     * @param key : The key identifying wanted value
+     * @return The raw value
+     */
+    std::string raw(const std::string &key) const
+    {
+        if (_frozen && _frozen->source(_frozen->index(key)) != NULL) return (_frozen->source(_frozen->index(key))->str());
+        template_map::const_iterator it = templates().find(key);
+
+        if (it != templates().end()) return (it->second);
+        return (find(key)->str());
+    }
+
+    //
+    // INTERPOLATION
+    //
+
+    /*!
+     * @brief Tests if a value holds references
+     * @param value : The value to scan
+     * @return true if the value needs to be expanded
+     */
+    static bool interpolated(const std::string &value)
+    {
+        return (interpolation_begin::size() > 0 && interpolation_begin::find(value) != std::string::npos);
+    }
+
+    /*!
+     * @brief Lists the keys or environment variables referenced by a value
+     * @param value : The value to scan
+     * @return The names referenced, in order of appearance
+     */
+    static std::vector<std::string> references(const std::string &value)
+    {
+        std::vector<std::string> names;
+
+        for (size_t begin = interpolation_begin::find(value); begin != std::string::npos; begin = interpolation_begin::find(value, begin + 1))
+        {
+            if (begin > 0 && value[begin - 1] == Grammar::escapeCharacter()) continue; //Escaped sequence
+            size_t end = interpolation_end::find(value, begin + interpolation_begin::size());
+            if (end == std::string::npos) break;
+            names.push_back(value.substr(begin + interpolation_begin::size(), end - (begin + interpolation_begin::size())));
+        }
+        return (names);
+    }
+
+    /*!
+     * @brief Replaces every reference of a value with the referenced key, or environment variable.
+     * References to neither are kept as they are written, so that a misspelled name stays visible.
+     * @param value : The value to expand
+     * @return The expanded value
+     */
+    std::string expand(const std::string &value) const
+    {
+        std::string expanded;
+        size_t cursor = 0;
+
+        for (size_t begin = interpolation_begin::find(value); begin != std::string::npos; begin = interpolation_begin::find(value, begin + 1))
+        {
+            if (begin > 0 && value[begin - 1] == Grammar::escapeCharacter()) continue; //Escaped sequence
+            size_t end = interpolation_end::find(value, begin + interpolation_begin::size());
+            if (end == std::string::npos) break;
+            std::string name = value.substr(begin + interpolation_begin::size(), end - (begin + interpolation_begin::size()));
+            const Value *referenced = find(name);
+
+            expanded.append(value, cursor, begin - cursor);
+            if (referenced != NULL)
+            {
+                expanded.append(referenced->data(), referenced->size());
+            }
+            else if (getenv(name.c_str()) != NULL)
+            {
+                expanded += getenv(name.c_str());
+            }
+            else
+            {
+                expanded.append(value, begin, end + interpolation_end::size() - begin); //Unresolved, kept literally
+            }
+            cursor = end + interpolation_end::size();
+            begin = cursor - 1;
+        }
+        expanded.append(value, cursor, std::string::npos);
+        return (expanded);
     }
 
-
     /*!
-     * @brief Checks if configuration is empty
-     * @return true if empty, false if not
+     * @brief Tests if a key is reachable from another through references
+     * @param from : The key to start from
+     * @param key : The key to reach
+     * @param visited : The keys already walked through
+     * @return true if key is reachable
      */
-    bool empty()
+    bool reaches(const std::string &from, const std::string &key, std::set<std::string> &visited) const
     {
-        return (_config.empty());
+        if (from == key) return (true);
+        if (!visited.insert(from).second) return (false);
+        template_map::const_iterator it = templates().find(from);
+        if (it == templates().end()) return (false);
+        std::vector<std::string> names = references(it->second);
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (reaches(names[i], key, visited)) return (true);
+        }
+        return (false);
     }
 
     /*!
-     * @brief Empties configuration keys and values in memory
+     * @brief Tests if setting a value would make a key reference itself
+     * @param key : The key to set
+     * @param value : The value to set
+     * @return true if a reference of the value leads back to the key
      */
-    void clear()
+    bool cyclic(const std::string &key, const std::string &value) const
     {
-        _config.clear();
+        std::vector<std::string> names = references(value);
+        std::set<std::string> visited;
+
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (reaches(names[i], key, visited)) return (true);
+        }
+        return (false);
     }
 
     /*!
-     * @brief Reload configuration from associated file
+     * @brief Registers a value containing references, and stores its expansion
+     * @param key : The key indentifier to set
+     * @param value : The value containing references
      */
-    void reload()
+    void bind(const std::string &key, const std::string &value)
     {
-        relocate(_path);
+        std::vector<std::string> names = references(value);
+
+        if (cyclic(key, value))
+        {
+            throw (std::runtime_error("interpolation cycle: "+key)); //Key references itself !
+        }
+        unbind(key);
+        own(_templates)[key] = value;
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            own(_dependents)[names[i]].insert(key);
+        }
+        store(key, expand(value));
     }
 
     /*!
-     * @brief Reset object and load another configuration file
-     * @param path : The path to the configuration file to relocate to
+     * @brief Unregisters the references of a key
+     * @param key : The key to unregister
      */
-    void relocate(const std::string &path)
+    void unbind(const std::string &key)
     {
-        _path = path;
-        clear();
-        load();
+        if (templates().count(key) == 0) return;
+        template_map &bound = own(_templates);
+        dependency_map &referenced = own(_dependents);
+        template_map::iterator it = bound.find(key);
+        std::vector<std::string> names = references(it->second);
+
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            dependency_map::iterator dependents = referenced.find(names[i]);
+
+            if (dependents == referenced.end()) continue;
+            dependents->second.erase(key);
+            if (dependents->second.empty()) referenced.erase(dependents);
+        }
+        bound.erase(it);
     }
 
     /*!
-     * @brief Removes associated configuration file from disk
-     * @return true on success, false on failure
+     * @brief Expands again every key referencing a modified key
+     * @param key : The modified key
      */
-    bool destroy()
+    void refresh(const std::string &key)
     {
-        if (getPath().empty()) throw(std::runtime_error("no_file_bound")); //No file bound to configuration
-        return (destroy(_path));
+        dependency_map::const_iterator dependents = dependencies().find(key);
+
+        if (dependents == dependencies().end()) return;
+        for (std::set<std::string>::const_iterator it = dependents->second.begin(); it != dependents->second.end(); it++)
+        {
+            store(*it, expand(templates().find(*it)->second));
+            refresh(*it);
+        }
     }
 
     /*!
-     * @brief Removes a given configuration file from disk
-     * @param path : The path to the configuration file to delete
-     * @return true on success, false on failure
+     * @brief Lists every key expanded again when a key changes, in the order refresh() expands them
+     * @param key : The modified key
+     * @param keys : The keys to append to
      */
-    static bool destroy(const std::string &path)
+    void collect(const std::string &key, std::vector<std::string> &keys) const
     {
-        return (remove(path.c_str()) == 0);
+        dependency_map::const_iterator dependents = dependencies().find(key);
+
+        if (dependents == dependencies().end()) return;
+        for (std::set<std::string>::const_iterator it = dependents->second.begin(); it != dependents->second.end(); it++)
+        {
+            keys.push_back(*it);
+            collect(*it, keys);
+        }
     }
 
     //
-    // GETTERS
+    // VALUE MANIPULATION
     //
 
     /*!
-     * @brief Tests if a key exists in configuration
-     * @param key : The key to search for
-     * @return true if found, false if failed
-     */
-    bool exists(const std::string &key)
-    {
-        return (_config.find(key) != _config.end());
-    }
-
-    /*!
-     * @brief Tests if a value equals a given param in configuration
-     * @param key : The key to search for
-     * @return true if equals, false if not
+     * @brief Converts any value to string, correctly.
+     * @param value : the T typed value to convert
+     * @return a string containing the value.
      */
     template <typename T>
-    bool compare(const std::string &key, const T &value)
+    static std::string stringify(const T &value) 
     {
-        if (_config.find(key) != _config.end())
+        std::string sValue;
+        if (std::is_same<T, bool>::value)
         {
-            if (_config[key] == value)
-                return (true);
+            sValue = (value ? "true" : "false");
         }
-        return (false);
+        else if (std::is_scalar<T>::value)
+        {
+            std::ostringstream out;
+
+            if (std::is_floating_point<T>::value)
+            {
+                out << std::setprecision(std::numeric_limits<long double>::digits10 + 1) << value;
+            }
+            else
+            {
+                out << value;
+            }
+            sValue = out.str();
+        }
+        else
+        {
+            sValue = value;
+        }
+        return (sValue);
     }
 
     /*!
-     * @brief Get arithmetic values from configuration
-     * @param key : The key identifying wanted value
-     * @param value : The arithmetic-typed variable to set with value
-     * @return true if found, false if failed
+     * @brief Converts a stored value to any arithmetic type.
+     * @param stored : the stored value
+     * @param value : the T typed variable to fill
      */
     template <typename T>
-    bool get(const std::string &key, T &value)
+    static void convert(const Value &stored, T &value)
     {
-        if (!exists(key)) return (false);
-        std::istringstream iss;
-        iss.str(_config[key]);
+        const T *converted = stored.elements<T>();
+
+        if (converted != NULL && stored.count() == 1) //Converted once when loaded
+        {
+            value = *converted;
+            return;
+        }
+        MemoryBuffer buffer(stored.data(), stored.size());
+        std::istream iss(&buffer);
+
         iss >> value;
-        return (true);
     }
 
     /*!
-     * @brief Get C-style string values from configuration
-     * @param key : The key identifying wanted value
-     * @param value : The char array to set with value
-     * @return true if found, false if failed
+     * @brief Converts a stored value to a C-style string.
+     * @param stored : the stored value
+     * @param value : the char array to fill
      */
-    bool get(const std::string &key, char *value)
+    static void convert(const Value &stored, char *value)
     {
-        if (!exists(key)) return (false);
-        strcpy(value, _config[key].c_str());
-        return (true);
+        memcpy(value, stored.data(), stored.size());
+        value[stored.size()] = '\0';
     }
 
     /*!
-     * @brief Get bool values from configuration
-     * @param key : The key identifying wanted value
-     * @param value : The bool to set with value
-     * @return true if found, false if failed
+     * @brief Converts a stored value to bool.
+     * @param stored : the stored value
+     * @param value : the bool to fill
      */
-    bool get(const std::string &key, bool &value)
+    static void convert(const Value &stored, bool &value)
     {
-        if (!exists(key)) return (false);
-        value = (_config[key] == "true" ? true : false);
-        return (true);
+        value = (stored == "true" ? true : false);
     }
 
     /*!
-     * @brief Get string values from configuration
-     * @param key : The key identifying wanted value
-     * @param value : The string to set with value
-     * @return true if found, false if failed
+     * @brief Converts a stored value to string.
+     * @param stored : the stored value
+     * @param value : the string to fill
      */
-    bool get(const std::string &key, std::string &value)
+    static void convert(const Value &stored, std::string &value)
     {
-        if (!exists(key)) return (false);
-        value = _config[key];
-        return (true);
+        value.assign(stored.data(), stored.size());
     }
 
     /*!
-     * @brief Get pair values from configuration
-     * @param key : The key identifying wanted value
-     * @param pair : The pair to fill with values
-     * @return true if found, false if failed
+     * @brief Converts a stored multi-value to a pair.
+     * @param stored : the stored value
+     * @param pair : the pair to fill
+     * @return true on success, false if the value holds a single field
      */
     template<typename Tx, typename Ty>
-    bool getPair(const std::string &key,  std::pair<Tx, Ty> &pair)
+    static bool convertPair(const Value &stored, std::pair<Tx, Ty> &pair)
     {
-        if (!exists(key)) return (false);
-        size_t sep = _config[key].find(VALUE_FIELD_SEPARATOR);
+        std::string str = stored.str();
+        size_t sep = value_field::find(str);
         if (sep != std::string::npos)
         {
-            std::string buffer = _config[key];
             std::istringstream iss;
 
-            iss.str(buffer.substr(0, sep));
+            iss.str(str.substr(0, sep));
             iss >> pair.first;
             iss.clear();
-            iss.str(buffer.substr(sep + strlen(VALUE_FIELD_SEPARATOR),
-                                        buffer.size() - sep + strlen(VALUE_FIELD_SEPARATOR)));
+            iss.str(str.substr(sep + value_field::size(),
+                                        str.size() - sep + value_field::size()));
             iss >> pair.second;
 			return (true);
         }
@@ -241,348 +3115,533 @@ public:
     }
 
     /*!
-     * @brief Used to get container-values from configuration
-     * @param key : The key identifying wanted container of values
-     * @param container : The container where the container of values will be pushed
-	 * @return true on success, false on failure.
+     * @brief Converts a stored multi-value to a container.
+     * @param stored : the stored value
+     * @param container : the container where the values will be pushed
      */
     template <typename T>
-    bool getContainer(const std::string &key, T &container)
+    static void convertContainer(const Value &stored, T &container)
     {
-        if (!exists(key)) return (false);
-        std::istringstream iss;
-        typename T::value_type value;
-        std::string buffer = _config[key];
+        typedef typename T::value_type element;
+        const element *elements = stored.elements<element>();
+
+        if (elements != NULL) //Packed numbers of the same type
+        {
+            extend(container, elements, elements + stored.count());
+            return;
+        }
 
-        for (size_t sep = buffer.find(VALUE_FIELD_SEPARATOR); sep != std::string::npos; sep = buffer.find(VALUE_FIELD_SEPARATOR))
+        const char *begin = stored.data(), *end = begin + stored.size(), *sep;
+        MemoryBuffer buffer(begin, 0);
+        std::istream iss(&buffer);
+        element value = element();
+
+        for (;; begin = sep + value_field::size())
         {
-            iss.str(buffer.substr(0, sep));
+            sep = value_field::scan(begin, end);
+            buffer.assign(begin, sep - begin);
+            iss.clear();
             iss >> value;
             container.insert(container.end(), value);
-            buffer.erase(0, sep + strlen(VALUE_FIELD_SEPARATOR));
-            iss.clear();
+            if (sep == end) break;
         }
-        iss.str(buffer);
-        iss >> value;
-        container.insert(container.end(), value);
-        return (true);
     }
 
-
-    //
-    // SETTERS
-    //
-
     /*!
-     * @brief Set configuration values with arithmetic types.
-     * @param key : The key indentifier to set
-     * @param value : The primitive-typed value to set in key field
+     * @brief Push numbers at the end of a container.
+     * @param container : the container where the values will be pushed
+     * @param first : the first number
+     * @param last : the end of the numbers
      */
-    template <typename T>
-    void set(const std::string &key, const T &value)
+    template <typename T, typename E>
+    static void extend(T &container, const E *first, const E *last)
     {
-        set(key, stringify(value));
+        for (; first != last; first++)
+        {
+            container.insert(container.end(), *first);
+        }
     }
 
-    /*!
-     * @brief Set configuration values with arithmetic types.
-     * @param key : The key indentifier to set
-     * @param value : The primitive-typed value to set in key field
-     */
-    void set(const std::string &key, const std::string &value)
+    template <typename E>
+    static void extend(std::vector<E> &container, const E *first, const E *last)
     {
-        if (exists(key)) _config[key] = value;
-        else _config.emplace(key, value);
+        container.insert(container.end(), first, last);
     }
 
+    /*! @brief Tells if a type of numbers is kept packed in memory by setContainer() */
+    template <typename T>
+    struct packable : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> {};
+
     /*!
-     * @brief Set configuration values with bool types.
+     * @brief Set configuration values with the text of a container.
      * @param key : The key indentifier to set
-     * @param value : The bool-typed value to set in key field
+     * @param container : The container with values to fill in key field
      */
-    void set(const std::string key, const bool &value)
+    template <typename T>
+    void setContainer(const std::string &key, const T &container, std::false_type)
     {
-        set(key, (value ? "true" : "false"));
+        std::string fValue;
+
+        for (typename T::const_iterator it = container.cbegin(); it != container.cend(); it++)
+        {
+            if (it != container.begin())
+            {
+                fValue += Grammar::valueFieldSeparator();
+            }
+            fValue += stringify(*it);
+        }
+        set(key, fValue);
     }
 
     /*!
-     * @brief Set configuration values with the contents of an std::pair.
+     * @brief Set configuration values with the packed numbers of a container.
      * @param key : The key indentifier to set
-     * @param pair : The pair with values to fill in key field
+     * @param container : The container with values to fill in key field
      */
-    template<typename Tx, typename Ty>
-    void setPair(const std::string &key, const std::pair<Tx, Ty> &pair)
+    template <typename T>
+    void setContainer(const std::string &key, const T &container, std::true_type)
     {
-        set(key, stringify(pair.first) + VALUE_FIELD_SEPARATOR + stringify(pair.second));
+        set(key, Value::pack<typename T::value_type>(container.begin(), container.end(), &format<typename T::value_type>));
     }
 
     /*!
-     * @brief Set configuration values with the contents of any stl container implementing const_iterator.
-     * @param key : The key indentifier to set
-     * @param container : The container with values to fill in key field
+     * @brief Build the text of packed numbers, as setContainer() would have stored it.
+     * @param elements : the numbers
+     * @param count : the number of numbers
+     * @param text : the string to fill
      */
     template <typename T>
-    void setContainer(const std::string &key, const T &container)
+    static void format(const void *elements, size_t count, std::string &text)
     {
-        std::string fValue;
+        const T *values = static_cast<const T *>(elements);
+        std::ostringstream out;
 
-        for (typename T::const_iterator it = container.cbegin(); it != container.cend(); it++)
+        if (std::is_floating_point<T>::value)
         {
-            if (it != container.begin())
-            {
-                fValue += VALUE_FIELD_SEPARATOR;
-            }
-            fValue += stringify(*it);
+            out << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
         }
-        set(key, fValue);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (i > 0) out << Grammar::valueFieldSeparator();
+            out << values[i];
+        }
+        text = out.str();
     }
 
     //
-    // MODIFIERS
+    // LOADING
     //
 
     /*!
-     * @brief Used to rename configuration key
-     * @param srcKey : The source key containing the value to copy
-     * @param destKey : The destination key fill with source value
+     * @brief Set a loaded association that holds or may affect references.
+     * A cycle is reported as an error of the load, and the key is skipped, instead of throwing with the file half loaded.
+     * @param section : The section of the association
+     * @param pair : The association, with its key relative to the section
+     * @param line : The line of the file holding the association
      */
-    void move(const std::string &srcKey, const std::string &destKey)
+    void assign(const std::string &section, const association &pair, size_t line)
     {
-        if (exists(srcKey))
-        {
-           copy(srcKey, destKey);
-           erase(srcKey);
-        }
-        else
+        std::string key = join(section, pair.first); //References need the full key
+        ValidationError error;
+
+        if (interpolated(pair.second) && cyclic(key, pair.second))
         {
-            throw (std::runtime_error("undefined key: "+srcKey)); //No source to move from !
+            error.line = line;
+            error.key = key;
+            error.message = "interpolation cycle";
+            _errors.push_back(error);
+            return;
         }
+        set(key, pair.second);
+        if (_schema) validate(section, pair.first, line);
     }
 
+    /*!
+     * @brief Check a value that was set with its references expanded, converting it as values without references are
+     * @param section : The section of the association
+     * @param key : The key, relative to the section
+     * @param line : The line of the file holding the association
+     */
+    void validate(const std::string &section, const std::string &key, size_t line)
+    {
+        if (!_schema || lookup(join(section, key)) == NULL) return;
+        Value &stored = detach(section)[key];
+        uint64_t version = stored._version;
 
+        _schema->check(section, key, stored, line, _errors);
+        stored._version = version;
+    }
 
     /*!
-     * @brief Used to copy configuration value into another
-     * @param srcKey : The source key containing the value to copy
-     * @param destKey : The destination key fill with source value
+     * @brief Load config stored in the associated file, keeping values inside a mapping of the file.
+     * Lines holding sections, quotes, escapes, block comments or references are parsed as load() does.
+     * @return true on success, false on failure.
      */
-    void copy(const std::string &srcKey, const std::string &destKey)
+    bool loadMapped()
     {
-        if (exists(srcKey))
+        file_state state = inspect(_path); //Before reading, so that later writes are noticed
+        bool merged = !empty(); //Keys set before are not in the file
+        Value file = (state.exists ? Value::map(_path) : Value()); //No config file exists, nothing to load
+        const char *begin = file.data(), *end = begin + file.size(), *eol, *cursor, *sep, *found;
+        std::string section, current, line;
+        association pair;
+        association_map *target = NULL;
+        bool comment = false, plain, blank;
+        uint64_t version = touch(); //Every key loaded shares a version
+        size_t number = 0;
+
+        for (; begin < end; begin = eol + 1)
         {
-            if (_config.find(destKey) != _config.end())
+            number++;
+            eol = static_cast<const char *>(memchr(begin, '\n', end - begin));
+            if (eol == NULL) eol = end;
+            plain = (!comment && templates().empty() && dependencies().empty());
+            blank = true;
+            for (cursor = begin; plain && cursor < eol && !comment_line::test(*cursor); cursor++) //Look for syntax that needs the full parser
             {
-                _config[destKey] = _config[srcKey];
+                plain = !(string_identifiers::test(*cursor) || *cursor == Grammar::escapeCharacter()
+                          || comment_begin::match(cursor, eol) || section_begin::match(cursor, eol)
+                          || interpolation_begin::match(cursor, eol));
+                blank = (blank && *cursor == ' ');
             }
-            else
+            if (plain && blank) continue; //Blank or commented line
+            for (sep = NULL, found = (plain ? key_value::scan(begin, cursor) : cursor); found != cursor; found = key_value::scan(found + 1, cursor))
             {
-                _config.emplace(destKey, srcKey);
+                sep = found; //The last separator splits the line, as parseBuffer() does
+            }
+            if (plain && sep != NULL)
+            {
+                if (target == NULL || section != current)
+                {
+                    target = &detach(section);
+                    current = section;
+                }
+                std::string key(begin, sep);
+                Value &stored = (*target)[key];
+
+                stored = file.slice(sep + key_value::size() - file.data(), cursor - (sep + key_value::size()));
+                if (_schema) _schema->check(section, key, stored, number, _errors);
+                stored._version = version;
+                continue;
+            }
+            line.assign(begin, eol);
+            if (formatBuffer(line, section, comment))
+            {
+                pair = parseBuffer(line);
+                if (interpolated(pair.second) || !templates().empty() || !dependencies().empty())
+                {
+                    assign(section, pair, number);
+                    continue;
+                }
+                if (target == NULL || section != current)
+                {
+                    target = &detach(section);
+                    current = section;
+                }
+                Value &stored = (*target)[pair.first];
+
+                stored = make(pair.second);
+                if (_schema) _schema->check(section, pair.first, stored, number, _errors);
+                stored._version = version;
             }
         }
-        else
-        {
-            throw (std::runtime_error("undefined key: "+srcKey)); //No source to move from !
-        }
+        record(state, digest(file), merged);
+        if (file.size() > 0) madvise(const_cast<char *>(file.data()), file.size(), MADV_DONTNEED); //Only pages read again stay resident
+        if (_schema) _schema->complete(*this, _errors);
+        return (_errors.empty());
+    }
+
+    //
+    // FINGERPRINTS
+    //
+
+    /*! @brief State of the associated file and of the configuration, when it was last loaded or saved */
+    struct file_state
+    {
+        file_state() : known(false), exists(false), racy(true), merged(false), device(0), inode(0), size(0), seconds(0), nanoseconds(0), digest(0), content(0), epoch(0) {}
+
+        bool known;
+        bool exists;
+        bool racy; //Modified too recently for the timestamp to tell later writes apart
+        bool merged; //Loaded over keys that were set before, which the file lacks
+        std::string path;
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        time_t seconds;
+        long nanoseconds;
+        uint64_t digest;
+        uint64_t content;
+        uint64_t epoch;
+    };
+
+    /*!
+     * @brief Get the size, timestamp and identity of a file, without reading it
+     * @param path : The path to the file
+     * @return The state of the file, its digest and contents are left empty
+     */
+    static file_state inspect(const std::string &path)
+    {
+        file_state state;
+        struct stat status;
+        struct timespec now;
+
+        state.known = true;
+        state.path = path;
+        state.exists = (::stat(path.c_str(), &status) == 0);
+        if (!state.exists) return (state);
+        state.device = status.st_dev;
+        state.inode = status.st_ino;
+        state.size = status.st_size;
+        state.seconds = status.st_mtim.tv_sec;
+        state.nanoseconds = status.st_mtim.tv_nsec;
+        clock_gettime(CLOCK_REALTIME, &now);
+        state.racy = (state.seconds + 2 > now.tv_sec); //Some filesystems only keep the time within two seconds
+        return (state);
+    }
+
+    /*!
+     * @brief Tests if two states describe the same file, unmodified
+     * @param a : The first state
+     * @param b : The second state
+     * @return true if identical
+     */
+    static bool same(const file_state &a, const file_state &b)
+    {
+        return (a.exists == b.exists && a.device == b.device && a.inode == b.inode && a.size == b.size
+                && a.seconds == b.seconds && a.nanoseconds == b.nanoseconds);
+    }
+
+    /*! @brief Write started by saveAsync(), recorded by the configuration once complete */
+    struct pending_write
+    {
+        pending_write() : done(false) {}
+
+        std::atomic<bool> done;
+        file_state state;
+    };
+
+    /*!
+     * @brief Remember the state of the associated file and of the configuration, once loaded or saved
+     * @param state : The state of the file, taken before reading it or after writing it
+     * @param digest : The digest of the lines read or written
+     * @param merged : true if the file was loaded over keys set before, the configuration then stays modified
+     */
+    void record(const file_state &state, uint64_t digest, bool merged = false)
+    {
+        _persisted = state;
+        _persisted.digest = digest;
+        _persisted.content = fingerprint(*snapshot());
+        _persisted.epoch = _epoch;
+        _persisted.merged = merged;
+        _pending.reset(); //Superseded
+    }
+
+    /*!
+     * @brief Prepare the background write of the configuration state, recorded by settle() once complete
+     * @return The operation writing the associated file
+     */
+    std::function<void()> writer()
+    {
+        std::shared_ptr<const section_map> config = snapshot();
+        std::shared_ptr<pending_write> pending = std::make_shared<pending_write>();
+        std::string path = _path;
+        uint64_t epoch = _epoch;
+
+        _pending = pending;
+        return ([config, path, epoch, pending]() {
+            uint64_t written = write(path, *config);
+            file_state state = inspect(path);
+
+            state.digest = written;
+            state.content = fingerprint(*config);
+            state.epoch = epoch;
+            pending->state = state;
+            pending->done.store(true, std::memory_order_release);
+        });
     }
 
     /*!
-     * @brief Erase a key from configuration
-     * @param key : The key to erase
+     * @brief Record the state written by the last saveAsync(), if the write completed
      */
-    void erase(const std::string &key)
+    void settle()
     {
-        if (exists(key))
-        {
-            _config.erase(key);
-        }
-        else
+        if (!_pending || !_pending->done.load(std::memory_order_acquire)) return;
+        _persisted = _pending->state;
+        _pending.reset();
+    }
+
+    /*!
+     * @brief Hash the lines of a file, as they are read
+     * @param lines : The lines, without their end of line
+     * @return The digest
+     */
+    static uint64_t digest(const std::vector<std::string> &lines)
+    {
+        uint64_t hash = Value::hash(NULL, 0);
+
+        for (size_t i = 0; i < lines.size(); i++)
         {
-            throw (std::runtime_error("undefined key:"+key)); //No key to erase !
+            hash = Value::hash("\n", 1, Value::hash(lines[i].data(), lines[i].size(), hash));
         }
+        return (hash);
     }
 
-    //
-    // LOAD / SAVE
-    //
+    /*!
+     * @brief Hash the characters of a file, as its lines are
+     * @param file : The characters of the file
+     * @return The digest, the same as the one of its lines
+     */
+    static uint64_t digest(const Value &file)
+    {
+        uint64_t hash = Value::hash(file.data(), file.size());
+
+        if (file.size() > 0 && file.data()[file.size() - 1] != '\n') hash = Value::hash("\n", 1, hash); //Last line has no end of line
+        return (hash);
+    }
 
     /*!
-     * @brief Load config stored in the associated file.
-     * @return true on success, false on failure.
+     * @brief Hash the sections, keys and values of a configuration state, as they are saved
+     * @param config : The configuration state
+     * @return The hash
      */
-    bool load()
+    static uint64_t fingerprint(const section_map &config)
     {
-		std::vector<std::string> buffer = dump();
-        std::string section;
-        association pair;
+        uint64_t hash = Value::hash(NULL, 0);
 
-        for (size_t i = 0; i < buffer.size(); i++)
+        for (section_map::const_iterator it = config.begin(); it != config.end(); it++)
         {
-            if (formatBuffer(buffer[i], section))
+            hash = Value::hash(it->first.c_str(), it->first.size() + 1, hash); //Terminator separates names
+            for (association_map::const_iterator key = it->second->begin(); key != it->second->end(); key++)
             {
-                pair = parseBuffer(buffer[i]);
-                if (!section.empty()) pair.first = section+SECTION_FIELD_SEPARATOR+pair.first;
-                set(pair.first, pair.second);
+                hash = Value::hash(key->first.c_str(), key->first.size() + 1, hash);
+                hash = Value::hash("\n", 1, Value::hash(key->second.data(), key->second.size(), hash));
             }
         }
-        return (true);
+        return (hash);
     }
 
+    //
+    // SERIALIZATION
+    //
+
     /*!
-     * @brief Save current config state inside associated file.
-     * @return true on success, false on failure.
+     * @brief Write a configuration state inside a given file.
+     * Lines of the file are kept in place with their values updated, new keys are added at the end of their section.
+     * @param path : The path to the configuration file to write
+     * @param config : The configuration state to write
+     * @param replace : true to write a new file in place of the previous one, which stays valid for its mappings,
+     *                  forced while the file is mapped in the process. The permissions of the file are kept,
+     *                  and a symbolic link is followed rather than replaced.
+     * @return The digest of the file written
      */
-    void save()
+    static uint64_t write(const std::string &path, const section_map &config, bool replace = false)
     {
-        association_map config = _config;
-        std::vector<std::string> buffer = dump(), serialized = buffer;
-        std::ofstream file(_path, std::ofstream::out | std::ofstream::trunc);
-        std::string section, prevSection, fileSection;
+        replace = (replace || Value::mapped(path)); //Truncating a mapped file would change the values referencing it
+        std::vector<std::string> buffer = dump(path), output;
+        std::string section, prevSection, line;
+        std::set<std::string> written, flushed;
         association pair;
+        bool comment = false;
 
-        if (!file.good())
-        {
-            throw (std::runtime_error("unable to open file")); //Couldnt open
-        }
         for (size_t i = 0; i < buffer.size(); i++)
         {
-            if (formatBuffer(serialized[i], section))
+            line = buffer[i];
+            if (formatBuffer(line, section, comment))
             {
-                pair = parseBuffer(serialized[i]);
-                if (config.find(pair.first) != config.end())
+                pair = parseBuffer(line);
+                section_map::const_iterator keys = config.find(section);
+                association_map::const_iterator it;
+
+                if (keys != config.end() && flushed.count(section) == 0 && (it = keys->second->find(pair.first)) != keys->second->end())
                 {
-                    if (!section.empty() && section != prevSection) //We are changing section, push all remaining new keys
-                    {
-                        for (association_map::iterator it = config.begin(); it != config.end(); it++)
-                        {
-                            if (getKeySection(it->first) == prevSection)
-                            {
-                                buffer.insert(std::next(buffer.begin(), static_cast<int64_t>(i)), getKeySection(it->first, false) + KEY_VALUE_SEPARATOR + it->second);
-                                config.erase(it);
-                            }
-                        }
-                    }
-                    buffer[i].replace(buffer[i].find(pair.second), pair.second.length(), pair.second);
-                    config.erase(pair.first);
-                    prevSection = section;
+                    if (it->second != pair.second) update(buffer[i], pair, it->second.str());
+                    written.insert(pair.first);
                 }
             }
-        }
-        //Push keys that are not inside file already
-        for (association_map::iterator it = config.begin(); it != config.end(); it++)
-        {
-            fileSection = getKeySection(it->first, true);
-            if (!fileSection.empty()) section = fileSection;
-            if (!section.empty() && section != prevSection) //We are changing section create it!
+            else if (section != prevSection) //We are changing section, push all remaining new keys
             {
-                file << SECTION_BLOCK_BEGIN+section+SECTION_BLOCK_END;
+                flush(output, config, prevSection, written, flushed);
+                prevSection = section;
             }
-            buffer.push_back(getKeySection(it->first, false) + KEY_VALUE_SEPARATOR + it->second);
-            prevSection = section;
+            output.push_back(buffer[i]);
         }
-        for (size_t i = 0; i < buffer.size(); i++)
+        flush(output, config, prevSection, written, flushed);
+        for (section_map::const_iterator it = config.begin(); it != config.end(); it++)
         {
-            file << buffer[i] << '\n';
+            if (flushed.count(it->first) == 0) dumpSection(output, it->first, *it->second);
         }
-        file.close();
-    }
 
-    //
-    // INTEROPERABILITY
-    //
+        std::string destination = path;
+        struct stat status;
 
-    /*!
-     * @brief Copies a given key to another configuration
-     * @param key : The key to copy
-     * @param target : The target configuration to copy to
-     */
-    void copyTo(const std::string &key, Config &target)
-    {
-        if (exists(key))
+        if (replace) //Replace the file a link points to, not the link
         {
-            target.set(key, _config[key]);
+            char *resolved = realpath(path.c_str(), NULL);
+
+            if (resolved != NULL) destination = resolved;
+            free(resolved);
         }
-        else
+        std::string target = (replace ? destination + ".tmp" : path);
+        std::ofstream file(target, std::ofstream::out | std::ofstream::trunc);
+        if (!file.good())
         {
-            throw (std::runtime_error("undefined key: "+key)); //No key to copy !
+            throw (std::runtime_error("unable to open file")); //Couldnt open
         }
-    }
-
-    /*!
-     * @brief Moves a given key to another configuration (removes key from caller)
-     * @param key : The key to move
-     * @param target : The target configuration to move to
-     */
-    void moveTo(const std::string &key, Config &target)
-    {
-        try {
-            copyTo(key, target);
+        for (size_t i = 0; i < output.size(); i++)
+        {
+            file << output[i] << '\n';
         }
-        catch(...)
+        file.close();
+        if (replace && stat(destination.c_str(), &status) == 0) chmod(target.c_str(), status.st_mode & 07777);
+        if (replace && rename(target.c_str(), destination.c_str()) != 0)
         {
-            return; //Failed! do not erase
+            remove(target.c_str());
+            throw (std::runtime_error("unable to replace file")); //Previous file is kept
         }
-        erase(key);
+        return (digest(output));
     }
 
     /*!
-     * @brief Append the target configuration to the caller
-     * @param source : The configuration to copy keys from
+     * @brief Push the keys of a section that were not written yet, and mark the section as done.
+     * @param output : The buffer to fill
+     * @param config : The configuration state to write
+     * @param section : The section to push
+     * @param written : The keys of the section already written, cleared on return
+     * @param flushed : The sections done
      */
-    void append(const Config &source)
+    static void flush(std::vector<std::string> &output, const section_map &config, const std::string &section,
+                      std::set<std::string> &written, std::set<std::string> &flushed)
     {
-        for (association_map::const_iterator it = source._config.begin(); it != source._config.end(); it++)
+        section_map::const_iterator keys = config.find(section);
+
+        if (keys != config.end() && flushed.insert(section).second)
         {
-            set(it->first, it->second);
+            for (association_map::const_iterator it = keys->second->begin(); it != keys->second->end(); it++)
+            {
+                if (written.count(it->first) == 0) output.push_back(it->first + Grammar::keyValueSeparator() + it->second.str());
+            }
         }
+        written.clear();
     }
 
     /*!
-     * @brief Append the configuration file to the caller
-     * @param path : The path to the configuration file to copy keys from
-     */
-    void append(const std::string &path)
-    {
-        append(Config(path));
-    }
-
-protected:
-
-    //
-    // VALUE MANIPULATION
-    //
-
-    /*!
-     * @brief Converts any value to string, correctly.
-     * @param value : the T typed value to convert
-     * @return a string containing the value.
+     * @brief Replace the value of a line, keeping the rest of the line untouched.
+     * @param line : The line to update
+     * @param pair : The association parsed from the line
+     * @param value : The new value
      */
-    template <typename T>
-    static std::string stringify(const T &value) 
+    static void update(std::string &line, const association &pair, const std::string &value)
     {
-        std::string sValue;
-        if (std::is_same<T, bool>::value)
-        {
-            sValue = (value ? "true" : "false");
-        }
-        else if (std::is_scalar<T>::value)
-        {
-            std::ostringstream out;
+        size_t sep = key_value::find(line);
+        size_t begin = (sep == std::string::npos ? std::string::npos : line.find(pair.second, sep + key_value::size()));
 
-            if (std::is_floating_point<T>::value)
-            {
-                out << std::setprecision(std::numeric_limits<long double>::digits10 + 1) << value;
-            }
-            else
-            {
-                out << value;
-            }
-            sValue = out.str();
-        }
-        else
+        if (begin == std::string::npos)
         {
-            sValue = value;
+            line = pair.first + Grammar::keyValueSeparator() + value;
+            return;
         }
-        return (sValue);
+        line.replace(begin, pair.second.length(), value);
     }
 
     //
@@ -596,34 +3655,23 @@ protected:
      */
     std::vector<std::string> dump() const
     {
-        std::ifstream file(_path, std::ifstream::in);
-        std::vector<std::string> buffer;
-        std::string line;
-
-        if (!file.good()) //No config, or could not open
-        {
-			return (buffer);
-        }
-        while (std::getline(file, line))
-            buffer.push_back(line);
-        file.close();
-        return (buffer);
+        return (dump(_path));
     }
 
     /*!
-     * @brief Dump current config file into a vector buffer.
+     * @brief Dump a given config file into a vector buffer.
+     * @param path : The path to the configuration file to dump
      * @return A vector buffer containing a dump of the config file.
      */
-    std::vector<std::string> dumpFile() const
+    static std::vector<std::string> dump(const std::string &path)
     {
-        std::ifstream file(_path, std::ifstream::in);
+        std::ifstream file(path, std::ifstream::in);
         std::vector<std::string> buffer;
         std::string line;
 
-        if (access(_path.c_str(), F_OK) == -1) return (buffer); //No config file exists, return empty buffer
-        else if (!file.good()) //Could not open
+        if (!file.good()) //No config, or could not open
         {
-            throw (std::runtime_error("bad file: "+_path));
+			return (buffer);
         }
         while (std::getline(file, line))
             buffer.push_back(line);
@@ -632,37 +3680,21 @@ protected:
     }
 
     /*!
-     * @brief Dump current configuration into a vector buffer.
-     * @param config : an optionnal configuration array to dump, if not specified, member will be used
-     * @return A vector buffer containing a dump of the configuration.
-     */
-    std::vector<std::string> dumpSection() const
-    {
-        return (dumpSection(_config));
-    }
-
-    /*!
-     * @brief Dump current configuration into a vector buffer.
-     * @param config : an optionnal configuration array to dump, if not specified, member will be used
-     * @return A vector buffer containing a dump of the configuration.
+     * @brief Dump a section into a vector buffer.
+     * @param buffer : The buffer to fill
+     * @param section : The name of the section
+     * @param keys : The keys of the section
      */
-    static std::vector<std::string> dumpSection(const association_map &config)
+    static void dumpSection(std::vector<std::string> &buffer, const std::string &section, const association_map &keys)
     {
-        std::string section, prevSection, keySection;
-        std::vector<std::string> buffer;
-
-        for (association_map::const_iterator it = config.begin(); it != config.end(); it++)
+        if (!section.empty())
         {
-            keySection = getKeySection(it->first, true);
-            if (!keySection.empty()) section = keySection;
-            if (section != prevSection) //We are changing section create it!
-            {
-                buffer.push_back(SECTION_BLOCK_BEGIN+section+SECTION_BLOCK_END);
-            }
-            buffer.push_back(getKeySection(it->first, false) + KEY_VALUE_SEPARATOR + it->second);
-            prevSection = section;
+            buffer.push_back(Grammar::sectionBlockBegin()+section+Grammar::sectionBlockEnd());
+        }
+        for (association_map::const_iterator it = keys.begin(); it != keys.end(); it++)
+        {
+            buffer.push_back(it->first + Grammar::keyValueSeparator() + it->second.str());
         }
-        return (buffer);
     }
 
     /*!
@@ -674,15 +3706,15 @@ protected:
 	{
 		for (size_t begin = 0; begin < buffer.length(); begin++)
 		{
-			if (buffer.compare(begin, strlen(SECTION_BLOCK_BEGIN), SECTION_BLOCK_BEGIN) == 0//identifier found
-				&& (begin == 0 || (begin > 0 && buffer[begin - 1] != ESCAPE_CHARACTER))) //check for non escaped sequence
+			if (section_begin::match(buffer, begin) //identifier found
+				&& (begin == 0 || (begin > 0 && buffer[begin - 1] != Grammar::escapeCharacter()))) //check for non escaped sequence
 			{
 				for (size_t end = 0; end < buffer.length(); end++)
 				{
-					if (buffer.compare(end, strlen(SECTION_BLOCK_END), SECTION_BLOCK_END) == 0//identifier found
-						&& (end == 0 || (end > 0 && buffer[end - 1] != ESCAPE_CHARACTER))) //check for non escaped sequence
+					if (section_end::match(buffer, end) //identifier found
+						&& (end == 0 || (end > 0 && buffer[end - 1] != Grammar::escapeCharacter()))) //check for non escaped sequence
 					{
-						return (buffer.substr(begin + strlen(SECTION_BLOCK_BEGIN), end - (begin + strlen(SECTION_BLOCK_BEGIN))));
+						return (buffer.substr(begin + section_begin::size(), end - (begin + section_begin::size())));
 					}
 				}
 			}
@@ -690,30 +3722,6 @@ protected:
 		return ("");
 	}
 
-    /*!
-     * @brief Filter the key for section
-     * @param section : true to return section, false to return key
-     * @return key or section based on param section
-     */
-    static std::string getKeySection(const std::string &key, bool section = true)
-    {
-        size_t sep;
-
-        for (size_t cursor = 0; cursor < key.length(); cursor++)
-        {
-          if (key.compare(cursor, strlen(SECTION_FIELD_SEPARATOR), SECTION_FIELD_SEPARATOR) == 0//identifier found
-          && (cursor == 0 || (cursor > 0 && key[cursor-1] != ESCAPE_CHARACTER))) //check for non escaped sequence
-            {
-                if (section)
-                    return (key.substr(0, cursor));
-                else
-                    return (key.substr(cursor + strlen(SECTION_FIELD_SEPARATOR), key.length() - cursor + strlen(SECTION_FIELD_SEPARATOR)));
-            }
-        }
-        if (section) return (""); //no section
-		return (key);
-    }
-
     //
     // PARSER
     //
@@ -722,11 +3730,11 @@ protected:
      * @brief Check for comments in a given string, and removes them if any
      * @param buffer : string to parse for comments
      * @param section : string to fill with detected section
+     * @param inside : whether a comment block is open, updated for the next line
      * @return true when the buffer contains a valid key/value node
      */
-    bool formatBuffer(std::string &buffer, std::string &section)
+    static bool formatBuffer(std::string &buffer, std::string &section, bool &inside)
     {
-        static bool inside = false;
 		std::string newsection;
         size_t begin = 0;
 
@@ -735,28 +3743,22 @@ protected:
             while (cursor < buffer.length() && buffer[cursor] == ' ') cursor++;
             if (inside) //If we are inside block
             {
-                if (buffer.compare(cursor, strlen(COMMENT_BLOCK_END), COMMENT_BLOCK_END) == 0) //End found
+                if (comment_end::match(buffer, cursor)) //End found
                 {
                     inside = false;
-                    buffer.erase(begin, cursor + strlen(COMMENT_BLOCK_END));
+                    buffer.erase(begin, cursor + comment_end::size());
                 }
             }
             else //If not inside block
             {
-                if (buffer.compare(cursor, strlen(COMMENT_BLOCK_BEGIN), COMMENT_BLOCK_BEGIN) == 0) //Block found
+                if (comment_begin::match(buffer, cursor)) //Block found
                 {
                     inside = true;
                     begin = cursor;
                 }
-                else //check for line separator
+                else if (comment_line::test(buffer[cursor])) //line separator found
                 {
-                    for (size_t i = 0; i < strlen(COMMENT_LINE_SEPARATORS); i++)
-                    {
-                        if (buffer[cursor] == COMMENT_LINE_SEPARATORS[i]) //separator found
-                        {
-                            buffer = buffer.substr(0, cursor);
-                        }
-                    }
+                    buffer = buffer.substr(0, cursor);
                 }
             }
         }
@@ -766,7 +3768,7 @@ protected:
 			section = newsection;
 			return (false);
 		}
-        return (!inside);
+        return (!inside && buffer.find_first_not_of(' ') != std::string::npos); //Blank lines hold no node
     }
 
     /*!
@@ -774,7 +3776,7 @@ protected:
      * @param line : string to parse for key/value
      * @return pair of key and value
      */
-    association parseBuffer(std::string &buffer)
+    static association parseBuffer(std::string &buffer)
     {
         association pair;
         size_t separator = 0, begin = 0;
@@ -783,33 +3785,31 @@ protected:
         for (size_t cursor = 0; cursor < buffer.length(); cursor++) //Parse line
         {
             while (cursor < buffer.length() && buffer[cursor] == ' ') cursor++;
-            for (size_t i = 0; i < strlen(STRING_IDENTIFIERS); i++) //check for string identifiers
+            if (cursor < buffer.length() && string_identifiers::test(buffer[cursor]) //identifier found
+            && (cursor == 0 || (cursor > 0 && buffer[cursor-1] != Grammar::escapeCharacter()))) //check for non escaped sequence
             {
-                if (buffer[cursor] == STRING_IDENTIFIERS[i] //identifier found
-                && (cursor == 0 || (cursor > 0 && buffer[cursor-1] != ESCAPE_CHARACTER))) //check for non escaped sequence
+                char identifier = buffer[cursor];
+                begin = cursor;
+                while (cursor < buffer.length()) //while not at the end
                 {
-                    begin = cursor;
-                    while (cursor < buffer.length()) //while not at the end
+                    if (buffer[cursor] == identifier //if we are on an identifier
+                    && (cursor == 0 || (cursor > 0 && buffer[cursor-1] != Grammar::escapeCharacter()))) //check for non escaped sequence
                     {
-                        if (buffer[cursor] == STRING_IDENTIFIERS[i] //if we are on an identifier
-                        && (cursor == 0 || (cursor > 0 && buffer[cursor-1] != ESCAPE_CHARACTER))) //check for non escaped sequence
+                        if (!sepFound)
                         {
-                            if (!sepFound)
-                            {
-                                pair.first = buffer.substr(begin, cursor);
-                            }
-                            else
-                            {
-                                pair.second = buffer.substr(begin, cursor);
-                                return (pair);
-                            }
+                            pair.first = buffer.substr(begin, cursor);
+                        }
+                        else
+                        {
+                            pair.second = buffer.substr(begin, cursor);
+                            return (pair);
                         }
-                        cursor++;
                     }
+                    cursor++;
                 }
             }
-            if (buffer.compare(cursor, strlen(KEY_VALUE_SEPARATOR), KEY_VALUE_SEPARATOR) == 0 //sep found
-            && (cursor == 0 || (cursor > 0 && buffer[cursor-1] != ESCAPE_CHARACTER))) //check for non escaped sequence
+            if (key_value::match(buffer, cursor) //sep found
+            && (cursor == 0 || (cursor > 0 && buffer[cursor-1] != Grammar::escapeCharacter()))) //check for non escaped sequence
             {
                 separator = cursor;
                 sepFound = true;
@@ -817,7 +3817,7 @@ protected:
         }
         //If we end here, no identifiers were found
         pair.first = buffer.substr(0, separator);
-        pair.second = buffer.substr(separator + strlen(KEY_VALUE_SEPARATOR), buffer.length() - separator + strlen(KEY_VALUE_SEPARATOR));
+        pair.second = buffer.substr(separator + key_value::size(), buffer.length() - separator + key_value::size());
         return (pair);
     }
 
@@ -825,10 +3825,188 @@ protected:
     // MEMBERS
     //
 
-    association_map _config;
+    std::shared_ptr<section_map> _config;
+    std::shared_ptr<template_map> _templates;
+    std::shared_ptr<dependency_map> _dependents;
     std::string _path;
+    std::shared_ptr<value_pool> _pool;
+    bool _interning;
+    bool _mapping;
+    std::shared_ptr<const frozen_table> _frozen;
+    fallback _defaults;
+    uint64_t _epoch;
+    uint64_t _batch;
+    std::shared_ptr<const validator> _schema;
+    std::vector<ValidationError> _errors;
+    file_state _persisted;
+    std::shared_ptr<pending_write> _pending;
+};
+
+/*! @brief Config using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicConfig<> Config;
+
+/*!
+ * @class BasicTransaction
+ * @brief Batch of modifications of a configuration, made visible all at once
+ *
+ * Modifications are staged on a copy of the configuration, which shares every section it does not modify,
+ * then the staged contents are swapped in by commit(): readers see either none or all of them, under a single version.
+ * Settings changed on the configuration meanwhile, such as its path or schema, are kept.
+ * A transaction that is not committed, or throws before commit(), leaves the configuration untouched.
+ */
+template <typename Grammar = Syntax>
+class BasicTransaction
+{
+public:
+    /*! @brief Type of the configuration modified */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*!
+     * @brief Transaction standard constructor, see BasicConfig::begin()
+     * @param config : The configuration to modify
+     */
+    explicit BasicTransaction(config_type &config) : _target(&config), _staged(config), _base(config._epoch)
+    {
+        _staged._batch = config_type::tick();
+    }
+
+    //
+    // STAGING
+    //
+
+    /*!
+     * @brief Stage a value, see BasicConfig::set()
+     * @param key : The key indentifier to set
+     * @param value : The value to set in key field
+     * @return the transaction, to chain modifications
+     */
+    template <typename T>
+    BasicTransaction &set(const std::string &key, const T &value)
+    {
+        staged().set(key, value);
+        return (*this);
+    }
+
+    /*!
+     * @brief Stage a pair of values, see BasicConfig::setPair()
+     * @param key : The key indentifier to set
+     * @param pair : The pair with values to fill in key field
+     * @return the transaction, to chain modifications
+     */
+    template<typename Tx, typename Ty>
+    BasicTransaction &setPair(const std::string &key, const std::pair<Tx, Ty> &pair)
+    {
+        staged().setPair(key, pair);
+        return (*this);
+    }
+
+    /*!
+     * @brief Stage a container of values, see BasicConfig::setContainer()
+     * @param key : The key indentifier to set
+     * @param container : The container with values to fill in key field
+     * @return the transaction, to chain modifications
+     */
+    template <typename T>
+    BasicTransaction &setContainer(const std::string &key, const T &container)
+    {
+        staged().setContainer(key, container);
+        return (*this);
+    }
+
+    /*!
+     * @brief Stage the removal of a key, see BasicConfig::erase()
+     * @param key : The key to erase
+     * @return the transaction, to chain modifications
+     */
+    BasicTransaction &erase(const std::string &key)
+    {
+        staged().erase(key);
+        return (*this);
+    }
+
+    /*!
+     * @brief Stage the copy of a value, see BasicConfig::copy()
+     * @param srcKey : The source key containing the value to copy
+     * @param destKey : The destination key fill with source value
+     * @return the transaction, to chain modifications
+     */
+    BasicTransaction &copy(const std::string &srcKey, const std::string &destKey)
+    {
+        staged().copy(srcKey, destKey);
+        return (*this);
+    }
+
+    /*!
+     * @brief Get the configuration as it will be once committed
+     * @return The staged configuration
+     */
+    const config_type &view() const
+    {
+        return (_staged);
+    }
+
+    //
+    // COMPLETION
+    //
+
+    /*!
+     * @brief Make every staged modification visible at once
+     * Throws if the configuration was modified since the transaction began, leaving it untouched.
+     */
+    void commit()
+    {
+        if (_target == NULL) throw (std::runtime_error("transaction closed")); //Already committed or rolled back !
+        if (_target->_epoch != _base) throw (std::runtime_error("configuration modified during transaction")); //Would lose changes !
+        _target->writable();
+        _target->_config = std::move(_staged._config); //Only the contents, settings of the configuration are kept
+        _target->_templates = std::move(_staged._templates);
+        _target->_dependents = std::move(_staged._dependents);
+        _target->_pool = std::move(_staged._pool);
+        _target->_epoch = _staged._epoch;
+        _target = NULL;
+    }
+
+    /*!
+     * @brief Discard every staged modification
+     */
+    void rollback()
+    {
+        _target = NULL;
+        _staged = config_type(); //Release the sections staged
+    }
+
+    /*!
+     * @brief Tests if the transaction can still be committed
+     * @return true until commit() or rollback()
+     */
+    bool open() const
+    {
+        return (_target != NULL);
+    }
+
+protected:
+    /*!
+     * @brief Get the staged configuration, for modifications
+     * @return The staged configuration
+     */
+    config_type &staged()
+    {
+        if (_target == NULL) throw (std::runtime_error("transaction closed")); //Already committed or rolled back !
+        return (_staged);
+    }
+
+    //
+    // MEMBERS
+    //
+
+    config_type *_target;
+    config_type _staged;
+    uint64_t _base;
 };
 
+/*! @brief Transaction using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicTransaction<> Transaction;
+
 }
 
 #endif /* !TINYCONF_HPP_ */
\ No newline at end of file
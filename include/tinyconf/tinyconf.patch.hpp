@@ -0,0 +1,338 @@
+#ifndef TINYCONF_PATCH_HPP_
+#define TINYCONF_PATCH_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.patch.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for differences between configurations
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include "tinyconf.hpp"
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @class BasicPatch
+ * @brief Keys added, removed and modified between two configurations
+ *
+ * A patch is computed by a single merge of the ordered sections and keys of both configurations,
+ * sections still shared between copies are skipped without being walked.
+ * It can be applied to a configuration in place, and saved as text to be shipped:
+ * one change per line, "+Key=Value" when added, "~Key=Value" when modified, "-Key" when removed.
+ */
+template <typename Grammar = Syntax>
+class BasicPatch
+{
+public:
+    /*! @brief Type of the configurations compared */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*! @brief Kind of change of a key */
+    enum operation
+    {
+        Added,
+        Removed,
+        Modified
+    };
+
+    /*! @brief Change of a key, the value is empty when removed */
+    struct change
+    {
+        operation type;
+        std::string key;
+        Value value;
+    };
+
+    /*! @brief Container used to store the changes, ordered by section then by key */
+    typedef std::vector<change> change_list;
+
+    /*! @brief Patch empty constructor */
+    BasicPatch() {}
+
+    /*!
+     * @brief Compute the changes turning a configuration into another
+     * Values are compared as they are saved, with their references unexpanded.
+     * @param from : The configuration before the changes
+     * @param to : The configuration after the changes
+     * @return The patch
+     */
+    static BasicPatch diff(const config_type &from, const config_type &to)
+    {
+        std::shared_ptr<const typename config_type::section_map> before = from.snapshot(), after = to.snapshot();
+        typename config_type::section_map::const_iterator a = before->begin(), b = after->begin();
+        BasicPatch patch;
+
+        while (a != before->end() || b != after->end())
+        {
+            if (b == after->end() || (a != before->end() && a->first < b->first))
+            {
+                patch.push(Removed, a->first, *a->second);
+                a++;
+            }
+            else if (a == before->end() || b->first < a->first)
+            {
+                patch.push(Added, b->first, *b->second);
+                b++;
+            }
+            else
+            {
+                if (a->second != b->second) patch.merge(a->first, *a->second, *b->second); //Shared sections are identical
+                a++;
+                b++;
+            }
+        }
+        return (patch);
+    }
+
+    //
+    // CHANGES
+    //
+
+    /*!
+     * @brief Get the changes of the patch
+     * @return The changes, ordered by section then by key
+     */
+    const change_list &changes() const
+    {
+        return (_changes);
+    }
+
+    /*!
+     * @brief Get the number of changes
+     * @return The number of changes
+     */
+    size_t size() const
+    {
+        return (_changes.size());
+    }
+
+    /*!
+     * @brief Tests if the patch holds no change
+     * @return true if both configurations were identical
+     */
+    bool empty() const
+    {
+        return (_changes.empty());
+    }
+
+    /*!
+     * @brief Apply the changes to a configuration, without rebuilding it
+     * Removed keys that are already missing are ignored.
+     * @param config : The configuration to update
+     */
+    void apply(config_type &config) const
+    {
+        for (typename change_list::const_iterator it = _changes.begin(); it != _changes.end(); it++)
+        {
+            if (it->type == Removed)
+            {
+                if (config.lookup(it->key) != NULL) config.erase(it->key);
+            }
+            else if (it->value.packed())
+            {
+                config.set(it->key, it->value); //Numbers stay packed
+            }
+            else
+            {
+                config.set(it->key, it->value.str()); //References are bound again
+            }
+        }
+    }
+
+    //
+    // SERIALIZATION
+    //
+
+    /*!
+     * @brief Get the text of the patch
+     * @return The text, one change per line
+     */
+    std::string str() const
+    {
+        std::string text;
+
+        for (typename change_list::const_iterator it = _changes.begin(); it != _changes.end(); it++)
+        {
+            text += (it->type == Added ? '+' : (it->type == Removed ? '-' : '~'));
+            text += it->key;
+            if (it->type != Removed)
+            {
+                if (std::find(it->value.data(), it->value.data() + it->value.size(), '\n') != it->value.data() + it->value.size())
+                {
+                    throw (std::runtime_error("multi-line value: "+it->key)); //Cannot be written on a single line !
+                }
+                text += Grammar::keyValueSeparator();
+                text.append(it->value.data(), it->value.size());
+            }
+            text += '\n';
+        }
+        return (text);
+    }
+
+    /*!
+     * @brief Build a patch from its text
+     * @param text : The text, as returned by str()
+     * @return The patch
+     */
+    static BasicPatch parse(const std::string &text)
+    {
+        BasicPatch patch;
+        size_t begin = 0, end;
+
+        for (; begin < text.size(); begin = end + 1)
+        {
+            end = text.find('\n', begin);
+            if (end == std::string::npos) end = text.size();
+            if (end > begin && text[end - 1] == '\r') patch.read(text.substr(begin, end - begin - 1));
+            else if (end > begin) patch.read(text.substr(begin, end - begin));
+        }
+        return (patch);
+    }
+
+    /*!
+     * @brief Save the patch inside a file
+     * @param path : The path to the patch file
+     */
+    void save(const std::string &path) const
+    {
+        std::string text = str();
+        std::ofstream file(path, std::ofstream::out | std::ofstream::trunc);
+
+        if (!file.good())
+        {
+            throw (std::runtime_error("unable to open file")); //Couldnt open
+        }
+        file << text;
+        file.close();
+    }
+
+    /*!
+     * @brief Load a patch from a file
+     * @param path : The path to the patch file
+     * @return The patch
+     */
+    static BasicPatch load(const std::string &path)
+    {
+        std::ifstream file(path, std::ifstream::in);
+        std::ostringstream text;
+
+        if (!file.good())
+        {
+            throw (std::runtime_error("bad file: "+path)); //Couldnt open
+        }
+        text << file.rdbuf();
+        return (parse(text.str()));
+    }
+
+protected:
+    /*!
+     * @brief Record every key of a section as added or removed
+     * @param type : The kind of change
+     * @param section : The name of the section
+     * @param keys : The keys of the section
+     */
+    void push(operation type, const std::string &section, const typename config_type::association_map &keys)
+    {
+        for (typename config_type::association_map::const_iterator it = keys.begin(); it != keys.end(); it++)
+        {
+            push(type, config_type::join(section, it->first), (type == Removed ? Value() : it->second));
+        }
+    }
+
+    /*!
+     * @brief Record the changes between two versions of a section, in a single pass over both
+     * @param section : The name of the section
+     * @param before : The keys before the changes
+     * @param after : The keys after the changes
+     */
+    void merge(const std::string &section, const typename config_type::association_map &before, const typename config_type::association_map &after)
+    {
+        typename config_type::association_map::const_iterator a = before.begin(), b = after.begin();
+
+        while (a != before.end() || b != after.end())
+        {
+            if (b == after.end() || (a != before.end() && a->first < b->first))
+            {
+                push(Removed, config_type::join(section, a->first), Value());
+                a++;
+            }
+            else if (a == before.end() || b->first < a->first)
+            {
+                push(Added, config_type::join(section, b->first), b->second);
+                b++;
+            }
+            else
+            {
+                if (!same(a->second, b->second)) push(Modified, config_type::join(section, b->first), b->second);
+                a++;
+                b++;
+            }
+        }
+    }
+
+    /*!
+     * @brief Tests if two values are identical, without comparing characters when they reference the same ones
+     * @param a : The first value
+     * @param b : The second value
+     * @return true if identical
+     */
+    static bool same(const Value &a, const Value &b)
+    {
+        if (a.storage() != NULL && a.storage() == b.storage() && a.data() == b.data() && a.size() == b.size()) return (true); //Same slice of a storage
+        return (a == b);
+    }
+
+    /*!
+     * @brief Record a change
+     * @param type : The kind of change
+     * @param key : The full key
+     * @param value : The new value
+     */
+    void push(operation type, const std::string &key, const Value &value)
+    {
+        change entry;
+
+        entry.type = type;
+        entry.key = key;
+        entry.value = value;
+        _changes.push_back(entry);
+    }
+
+    /*!
+     * @brief Record the change written on a line
+     * @param line : The line, as written by str()
+     */
+    void read(const std::string &line)
+    {
+        size_t sep = line.find(Grammar::keyValueSeparator());
+
+        if (line[0] == '-')
+        {
+            push(Removed, line.substr(1), Value());
+        }
+        else if ((line[0] == '+' || line[0] == '~') && sep != std::string::npos)
+        {
+            push((line[0] == '+' ? Added : Modified), line.substr(1, sep - 1), Value(line.substr(sep + syntax::length(Grammar::keyValueSeparator()))));
+        }
+        else
+        {
+            throw (std::runtime_error("bad patch line: "+line)); //Unknown change !
+        }
+    }
+
+    //
+    // MEMBERS
+    //
+
+    change_list _changes;
+};
+
+/*! @brief Patch using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicPatch<> Patch;
+
+}
+
+#endif /* !TINYCONF_PATCH_HPP_ */
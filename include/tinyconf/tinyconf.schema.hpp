@@ -0,0 +1,379 @@
+#ifndef TINYCONF_SCHEMA_HPP_
+#define TINYCONF_SCHEMA_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.schema.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for configurations checked while they are loaded
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include <cerrno>
+#include <unordered_map>
+
+#include "tinyconf.hpp"
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @class BasicSchema
+ * @brief Types, ranges, required keys and allowed sections of a configuration
+ *
+ * Set on a configuration with BasicConfig::setSchema(), a schema is checked by load() in the same pass as the parser.
+ * Numbers are converted once and stored, so that reading them afterwards does not parse them again.
+ * Key patterns are full keys, where '*' matches any sequence of characters.
+ * @tparam Grammar : Syntax policy of the parser (see stb::Syntax)
+ */
+template <typename Grammar = Syntax>
+class BasicSchema : public BasicConfig<Grammar>::validator
+{
+public:
+    /*! @brief Type of the configurations checked */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*! @brief Schema empty constructor */
+    BasicSchema() {}
+
+    //
+    // RULES
+    //
+
+    /*!
+     * @brief Expect the values of matching keys to be of a type
+     * @param pattern : The full keys concerned, '*' matching any sequence of characters
+     * @return the schema, to chain declarations
+     */
+    template <typename T>
+    BasicSchema &expect(const std::string &pattern)
+    {
+        return (add(pattern, [](const Value &text, Value &value, std::string &message) -> bool {
+            T converted;
+
+            if (!parse(text, converted)) return (fail(message, "expected " + name<T>()));
+            store(text, converted, value);
+            return (true);
+        }));
+    }
+
+    /*!
+     * @brief Expect the values of matching keys to be numbers within a range
+     * @param pattern : The full keys concerned, '*' matching any sequence of characters
+     * @param min : The lowest value allowed
+     * @param max : The highest value allowed
+     * @return the schema, to chain declarations
+     */
+    template <typename T>
+    BasicSchema &expect(const std::string &pattern, const T &min, const T &max)
+    {
+        static_assert(std::is_arithmetic<T>::value, "only numbers have a range");
+        return (add(pattern, [min, max](const Value &text, Value &value, std::string &message) -> bool {
+            T converted;
+
+            if (!parse(text, converted)) return (fail(message, "expected " + name<T>()));
+            if (converted < min || converted > max) return (fail(message, "out of range [" + config_type::stringify(min) + ", " + config_type::stringify(max) + "]"));
+            store(text, converted, value);
+            return (true);
+        }));
+    }
+
+    /*!
+     * @brief Require a key to be defined
+     * @param key : The full key
+     * @return the schema, to chain declarations
+     */
+    BasicSchema &require(const std::string &key)
+    {
+        _required.push_back(key);
+        return (*this);
+    }
+
+    /*!
+     * @brief Allow a section, associations of sections that are not allowed are rejected once one is declared
+     * @param section : The name of the section, empty for keys outside of any section
+     * @return the schema, to chain declarations
+     */
+    BasicSchema &allow(const std::string &section)
+    {
+        _sections.insert(section);
+        return (*this);
+    }
+
+    //
+    // CHECKS
+    //
+
+    /*!
+     * @brief Check an association as it is loaded
+     * @param section : The section of the association
+     * @param key : The key, relative to the section
+     * @param value : The value, replaced with its conversion when a type is expected
+     * @param line : The line of the file holding the association
+     * @param errors : The errors to append to
+     */
+    void check(const std::string &section, const std::string &key, Value &value, size_t line, std::vector<ValidationError> &errors) const
+    {
+        std::string full = config_type::join(section, key);
+        const rule *found = match(full);
+        std::string message;
+
+        if (!_sections.empty() && _sections.count(section) == 0) report(errors, line, full, "section not allowed");
+        else if (found != NULL && !found->check(Value(value), value, message)) report(errors, line, full, message);
+    }
+
+    /*!
+     * @brief Check that every required key is defined
+     * @param config : The configuration loaded
+     * @param errors : The errors to append to
+     */
+    void complete(const config_type &config, std::vector<ValidationError> &errors) const
+    {
+        for (size_t i = 0; i < _required.size(); i++)
+        {
+            if (config.find(_required[i]) == NULL) report(errors, 0, _required[i], "required key missing");
+        }
+    }
+
+protected:
+    /*! @brief Check of a value, that converts it on success and describes the error on failure */
+    typedef std::function<bool(const Value &text, Value &value, std::string &message)> checker;
+
+    /*! @brief Keys matching a pattern, with their check */
+    struct rule
+    {
+        std::string pattern;
+        checker check;
+    };
+
+    /*!
+     * @brief Register a rule, keys without wildcard are found with a single lookup
+     * @param pattern : The full keys concerned
+     * @param check : The check of their values
+     * @return the schema, to chain declarations
+     */
+    BasicSchema &add(const std::string &pattern, const checker &check)
+    {
+        rule entry;
+
+        entry.pattern = pattern;
+        entry.check = check;
+        if (pattern.find('*') == std::string::npos) _exact[pattern] = _rules.size();
+        else _patterns.push_back(_rules.size());
+        _rules.push_back(entry);
+        return (*this);
+    }
+
+    /*!
+     * @brief Find the rule of a key, exact keys first then patterns in order of declaration
+     * @param key : The full key
+     * @return The rule, NULL if none
+     */
+    const rule *match(const std::string &key) const
+    {
+        std::unordered_map<std::string, size_t>::const_iterator it = _exact.find(key);
+
+        if (it != _exact.end()) return (&_rules[it->second]);
+        for (size_t i = 0; i < _patterns.size(); i++)
+        {
+            if (glob(_rules[_patterns[i]].pattern, key)) return (&_rules[_patterns[i]]);
+        }
+        return (NULL);
+    }
+
+    /*!
+     * @brief Tests if a key matches a pattern, '*' matching any sequence of characters
+     * @param pattern : The pattern
+     * @param key : The key
+     * @return true if matching
+     */
+    static bool glob(const std::string &pattern, const std::string &key)
+    {
+        size_t p = 0, k = 0, star = std::string::npos, resume = 0;
+
+        while (k < key.size())
+        {
+            if (p < pattern.size() && pattern[p] == '*')
+            {
+                star = p++;
+                resume = k;
+            }
+            else if (p < pattern.size() && pattern[p] == key[k])
+            {
+                p++;
+                k++;
+            }
+            else if (star != std::string::npos) //Let the last star match one more character
+            {
+                p = star + 1;
+                k = ++resume;
+            }
+            else return (false);
+        }
+        while (p < pattern.size() && pattern[p] == '*') p++;
+        return (p == pattern.size());
+    }
+
+    /*!
+     * @brief Append an error
+     * @param errors : The errors to append to
+     * @param line : The line of the association, 0 if none
+     * @param key : The full key
+     * @param message : The description of the error
+     */
+    static void report(std::vector<ValidationError> &errors, size_t line, const std::string &key, const std::string &message)
+    {
+        ValidationError error;
+
+        error.line = line;
+        error.key = key;
+        error.message = message;
+        errors.push_back(error);
+    }
+
+    /*! @brief Describe the failure of a check, and return false */
+    static bool fail(std::string &message, const std::string &reason)
+    {
+        message = reason;
+        return (false);
+    }
+
+    //
+    // CONVERSIONS
+    //
+
+    /*!
+     * @brief Get the bounds of the text of a value, without surrounding spaces
+     * @param text : The value
+     * @param number : The string to fill with the text, null terminated for strto*()
+     * @return false if the value is blank
+     */
+    static bool trim(const Value &text, std::string &number)
+    {
+        const char *begin = text.data(), *end = begin + text.size();
+
+        while (begin < end && *begin == ' ') begin++;
+        while (end > begin && end[-1] == ' ') end--;
+        number.assign(begin, end);
+        return (!number.empty());
+    }
+
+    /*!
+     * @brief Convert a value to a type, rejecting anything but the whole text
+     * @param text : The value
+     * @param value : The variable to fill
+     * @return true on success, false if the text is not of the type
+     */
+    template <typename T>
+    static bool parse(const Value &text, T &value)
+    {
+        return (parse(text, value, std::integral_constant<int, std::is_floating_point<T>::value ? 2 : std::is_signed<T>::value ? 1 : 0>()));
+    }
+
+    static bool parse(const Value &text, bool &value)
+    {
+        value = (text == "true");
+        return (value || text == "false");
+    }
+
+    static bool parse(const Value &text, std::string &value)
+    {
+        value = text.str();
+        return (true);
+    }
+
+    /*! @brief Unsigned integers */
+    template <typename T>
+    static bool parse(const Value &text, T &value, std::integral_constant<int, 0>)
+    {
+        std::string number;
+        char *end;
+
+        if (!trim(text, number) || number[0] == '-') return (false);
+        errno = 0;
+        unsigned long long converted = strtoull(number.c_str(), &end, 10);
+        if (errno != 0 || *end != '\0' || converted > std::numeric_limits<T>::max()) return (false);
+        value = static_cast<T>(converted);
+        return (true);
+    }
+
+    /*! @brief Signed integers */
+    template <typename T>
+    static bool parse(const Value &text, T &value, std::integral_constant<int, 1>)
+    {
+        std::string number;
+        char *end;
+
+        if (!trim(text, number)) return (false);
+        errno = 0;
+        long long converted = strtoll(number.c_str(), &end, 10);
+        if (errno != 0 || *end != '\0' || converted < std::numeric_limits<T>::min() || converted > std::numeric_limits<T>::max()) return (false);
+        value = static_cast<T>(converted);
+        return (true);
+    }
+
+    /*! @brief Floating point numbers */
+    template <typename T>
+    static bool parse(const Value &text, T &value, std::integral_constant<int, 2>)
+    {
+        std::string number;
+        char *end;
+
+        if (!trim(text, number)) return (false);
+        errno = 0;
+        long double converted = strtold(number.c_str(), &end);
+        if (errno != 0 || *end != '\0') return (false);
+        value = static_cast<T>(converted);
+        return (true);
+    }
+
+    /*!
+     * @brief Store the conversion of a number, keeping its text for saving
+     * @param text : The value as loaded
+     * @param converted : The number
+     * @param value : The value to replace
+     */
+    template <typename T>
+    static void store(const Value &text, const T &converted, Value &value)
+    {
+        store(text, converted, value, typename config_type::template packable<T>());
+    }
+
+    template <typename T>
+    static void store(const Value &text, const T &converted, Value &value, std::true_type)
+    {
+        value = Value::pack<T>(&converted, &converted + 1, &config_type::template format<T>, &text);
+    }
+
+    template <typename T>
+    static void store(const Value &, const T &, Value &, std::false_type)
+    {
+        //Text is already the value
+    }
+
+    /*! @brief Name of a type in error messages */
+    template <typename T>
+    static std::string name()
+    {
+        return (std::is_same<T, bool>::value ? "boolean"
+              : std::is_integral<T>::value ? "integer"
+              : std::is_floating_point<T>::value ? "number" : "value");
+    }
+
+    //
+    // MEMBERS
+    //
+
+    std::vector<rule> _rules;
+    std::unordered_map<std::string, size_t> _exact;
+    std::vector<size_t> _patterns;
+    std::vector<std::string> _required;
+    std::set<std::string> _sections;
+};
+
+/*! @brief Schema using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicSchema<> Schema;
+
+}
+
+#endif /* !TINYCONF_SCHEMA_HPP_ */
@@ -0,0 +1,201 @@
+#ifndef TINYCONF_SET_HPP_
+#define TINYCONF_SET_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.set.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for loading sets of configuration files
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <dirent.h>
+
+#include "tinyconf.hpp"
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @class BasicConfigSet
+ * @brief Set of configuration files loaded concurrently
+ */
+template <typename Grammar = Syntax>
+class BasicConfigSet
+{
+public:
+    /*! @brief Type of the configurations loaded */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*! @brief ConfigSet empty constructor */
+    BasicConfigSet() {}
+
+    /*!
+     * @brief ConfigSet directory constructor
+     * @param directory : The directory containing the configuration files
+     * @param extension : The extension of the files to load
+     */
+    BasicConfigSet(const std::string &directory, const std::string &extension = ".cfg")
+    {
+        load(directory, extension);
+    }
+
+    //
+    // LOAD
+    //
+
+    /*!
+     * @brief Load every configuration file of a directory, in parallel
+     * @param directory : The directory containing the configuration files
+     * @param extension : The extension of the files to load
+     * @param threads : The number of loading threads, 0 to use the number of cores
+     * @return The number of configurations loaded
+     */
+    size_t load(const std::string &directory, const std::string &extension = ".cfg", size_t threads = 0)
+    {
+        return (load(list(directory, extension), threads));
+    }
+
+    /*!
+     * @brief Load a list of configuration files, in parallel
+     * @param paths : The paths to the configuration files
+     * @param threads : The number of loading threads, 0 to use the number of cores
+     * @return The number of configurations loaded
+     */
+    size_t load(const std::vector<std::string> &paths, size_t threads = 0)
+    {
+        std::vector<config_type> configs(paths.size());
+        std::vector<std::thread> pool;
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        if (threads == 0) threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        threads = std::min(threads, paths.size());
+        for (size_t i = 0; i < threads; i++)
+        {
+            pool.push_back(std::thread([&]() {
+                for (size_t file = next++; file < paths.size(); file = next++)
+                {
+                    try {
+                        configs[file].setPath(paths[file]);
+                        configs[file].load();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(errorLock);
+                        if (!error) error = std::current_exception();
+                    }
+                }
+            }));
+        }
+        for (size_t i = 0; i < pool.size(); i++)
+        {
+            pool[i].join();
+        }
+        if (error) std::rethrow_exception(error);
+        _configs.insert(_configs.end(), std::make_move_iterator(configs.begin()), std::make_move_iterator(configs.end()));
+        return (configs.size());
+    }
+
+    /*!
+     * @brief List the configuration files of a directory
+     * @param directory : The directory containing the configuration files
+     * @param extension : The extension of the files to list
+     * @return The paths to the files, sorted
+     */
+    static std::vector<std::string> list(const std::string &directory, const std::string &extension = ".cfg")
+    {
+        std::vector<std::string> paths;
+        DIR *dir = opendir(directory.c_str());
+        std::string prefix = directory;
+
+        if (dir == NULL)
+        {
+            throw (std::runtime_error("bad directory: "+directory));
+        }
+        if (!prefix.empty() && prefix[prefix.length() - 1] != '/') prefix += '/';
+        for (struct dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+
+            if (name.length() > extension.length()
+            && name.compare(name.length() - extension.length(), extension.length(), extension) == 0)
+            {
+                paths.push_back(prefix + name);
+            }
+        }
+        closedir(dir);
+        std::sort(paths.begin(), paths.end());
+        return (paths);
+    }
+
+    //
+    // ACCESS
+    //
+
+    /*!
+     * @brief Get the number of configurations in the set
+     * @return The number of configurations
+     */
+    size_t size() const
+    {
+        return (_configs.size());
+    }
+
+    /*!
+     * @brief Get a configuration of the set
+     * @param index : The index of the configuration, in order of loading
+     * @return The configuration
+     */
+    config_type &at(size_t index)
+    {
+        return (_configs.at(index));
+    }
+
+    /*!
+     * @brief Get a configuration of the set
+     * @param index : The index of the configuration, in order of loading
+     * @return The configuration
+     */
+    const config_type &at(size_t index) const
+    {
+        return (_configs.at(index));
+    }
+
+    /*!
+     * @brief Merge the whole set in a single configuration
+     * @return The configuration, where later files override earlier ones
+     */
+    config_type merge() const
+    {
+        config_type merged;
+
+        for (size_t i = 0; i < _configs.size(); i++)
+        {
+            merged.append(_configs[i]);
+        }
+        return (merged);
+    }
+
+    /*!
+     * @brief Empties the set
+     */
+    void clear()
+    {
+        _configs.clear();
+    }
+
+protected:
+    std::vector<config_type> _configs;
+};
+
+/*! @brief Config set using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicConfigSet<> ConfigSet;
+
+}
+
+#endif /* !TINYCONF_SET_HPP_ */
@@ -0,0 +1,554 @@
+#ifndef TINYCONF_SHARED_HPP_
+#define TINYCONF_SHARED_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.shared.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for configurations shared between processes
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tinyconf.hpp"
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @brief Layout of the shared memory segments
+ *
+ * A publication is made of a control segment, named after the publication, holding the current generation,
+ * and of one data segment per generation, named "<name>.<generation>", that is never modified once published.
+ * Every offset is relative to the beginning of its segment, so that each process may map it anywhere.
+ * The control segment also identifies the publisher instance, so that readers notice when it is withdrawn or restarted.
+ */
+namespace shared {
+
+/*! @brief Magic number identifying tinyconf segments */
+static const uint64_t magic = 0x74696E79636F6E66ULL; //"tinyconf"
+
+/*! @brief Milliseconds between two attempts of a reader to reopen a withdrawn publication */
+static const int64_t retry = 100;
+
+/*! @brief Content of the control segment */
+struct Control
+{
+    uint64_t magic;
+    std::atomic<uint64_t> generation;
+    std::atomic<uint64_t> instance; //0 once the publisher is withdrawn
+};
+
+/*! @brief Header of a data segment, followed by the entries, the hash table, and the characters */
+struct Header
+{
+    uint64_t magic;
+    uint64_t generation;
+    uint64_t count;
+    uint64_t buckets;
+    uint64_t size;
+};
+
+/*! @brief Location of a key and its value inside a data segment */
+struct Entry
+{
+    uint64_t hash;
+    uint64_t key;
+    uint64_t keySize;
+    uint64_t value;
+    uint64_t valueSize;
+};
+
+/*!
+ * @brief Get the name of the data segment of a generation
+ * @param name : The name of the publication
+ * @param generation : The generation of the data
+ * @return The name of the segment
+ */
+inline std::string segment(const std::string &name, uint64_t generation)
+{
+    std::ostringstream ss;
+
+    ss << name << "." << generation;
+    return (ss.str());
+}
+
+/*!
+ * @brief Map a whole shared memory segment
+ * @param name : The name of the segment
+ * @param flags : The flags used to open the segment
+ * @param size : The size of the segment, 0 to map it entirely
+ * @return The address of the mapping, NULL if the segment could not be opened
+ */
+inline void *map(const std::string &name, int flags, size_t &size)
+{
+    int fd = shm_open(name.c_str(), flags, 0644);
+    struct stat st;
+    void *address;
+
+    if (fd == -1) return (NULL);
+    if (size == 0 && fstat(fd, &st) == 0) size = static_cast<size_t>(st.st_size);
+    else if ((flags & O_CREAT) && ftruncate(fd, static_cast<off_t>(size)) != 0) size = 0;
+    address = (size == 0 ? MAP_FAILED : mmap(NULL, size, ((flags & O_ACCMODE) == O_RDONLY ? PROT_READ : PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0));
+    close(fd);
+    if (address == MAP_FAILED) throw (std::runtime_error("unable to map shared segment: "+name));
+    return (address);
+}
+
+}
+
+/*!
+ * @class BasicConfigPublisher
+ * @brief Publishes snapshots of a configuration in shared memory
+ *
+ * Each publication is written to a fresh segment which is made visible by bumping the generation
+ * of the control segment, so readers either see the previous snapshot or the new one, never a mix.
+ * A single publisher per name is supported. Segments are removed when the publisher is destroyed,
+ * readers that already mapped them keep their snapshot.
+ */
+template <typename Grammar = Syntax>
+class BasicConfigPublisher
+{
+public:
+    /*! @brief Type of the configurations published */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*!
+     * @brief ConfigPublisher constructor
+     * @param name : The name of the publication, a shared memory name starting with '/'
+     */
+    explicit BasicConfigPublisher(const std::string &name) : _name(name), _size(sizeof(shared::Control))
+    {
+        struct stat st;
+        int fd;
+
+        if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos)
+        {
+            throw (std::runtime_error("invalid shared name: "+name));
+        }
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd == -1 || fstat(fd, &st) != 0) throw (std::runtime_error("unable to create shared segment: "+name));
+        close(fd);
+        _control = static_cast<shared::Control *>(shared::map(name, O_RDWR | O_CREAT, _size));
+        if (st.st_size == 0 || _control->magic != shared::magic) //Fresh segment, or left in an unknown state
+        {
+            new (_control) shared::Control();
+            _control->generation.store(0);
+            _control->magic = shared::magic;
+        }
+        if (!_control->generation.is_lock_free())
+        {
+            munmap(_control, _size);
+            throw (std::runtime_error("shared generation is not lock free"));
+        }
+        _control->instance.store(((static_cast<uint64_t>(getpid()) << 32)
+                                  ^ static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())) | 1,
+                                 std::memory_order_release);
+    }
+
+    /*! @brief ConfigPublisher destructor, removes the publication */
+    ~BasicConfigPublisher()
+    {
+        uint64_t generation = _control->generation.load();
+
+        _control->instance.store(0, std::memory_order_release); //Readers reopen the publication of the next publisher
+        if (generation > 0) shm_unlink(shared::segment(_name, generation).c_str());
+        munmap(_control, _size);
+        shm_unlink(_name.c_str());
+    }
+
+    /*!
+     * @brief Get the name of the publication
+     * @return The name given at construction
+     */
+    const std::string &getName() const
+    {
+        return (_name);
+    }
+
+    /*!
+     * @brief Get the generation currently visible to readers
+     * @return The generation, 0 if nothing was published yet
+     */
+    uint64_t generation() const
+    {
+        return (_control->generation.load(std::memory_order_acquire));
+    }
+
+    /*!
+     * @brief Publish a snapshot of a configuration, replacing the previous one.
+     * Values are published as they are read, with their references expanded.
+     * @param config : The configuration to publish
+     * @return The generation of the new snapshot
+     */
+    uint64_t publish(const config_type &config)
+    {
+        std::shared_ptr<const typename config_type::section_map> snapshot = config.view();
+        uint64_t previous = _control->generation.load(std::memory_order_acquire);
+        uint64_t generation = previous + 1;
+        std::string name = shared::segment(_name, generation);
+        std::vector<std::string> keys;
+        std::vector<const Value *> values;
+        uint64_t buckets = 1;
+        size_t size;
+        char *segment;
+
+        for (typename config_type::section_map::const_iterator section = snapshot->begin(); section != snapshot->end(); section++)
+        {
+            for (typename config_type::association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                keys.push_back(config_type::join(section->first, it->first));
+                values.push_back(&it->second);
+            }
+        }
+        while (buckets < keys.size() * 2) buckets <<= 1; //Load factor stays under one half
+        size = sizeof(shared::Header) + keys.size() * sizeof(shared::Entry) + buckets * sizeof(uint64_t);
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            size += keys[i].size() + values[i]->size();
+        }
+        shm_unlink(name.c_str()); //Leftover of a previous publisher
+        segment = static_cast<char *>(shared::map(name, O_RDWR | O_CREAT | O_EXCL, size));
+        if (segment == NULL) throw (std::runtime_error("unable to create shared segment: "+name));
+        layout(segment, size, generation, buckets, keys, values);
+        munmap(segment, size);
+        _control->generation.store(generation, std::memory_order_release);
+        if (previous > 0) shm_unlink(shared::segment(_name, previous).c_str());
+        return (generation);
+    }
+
+protected:
+    /*!
+     * @brief Write the header, entries, hash table and characters of a snapshot
+     * @param segment : The mapped segment to fill
+     * @param size : The size of the segment
+     * @param generation : The generation of the snapshot
+     * @param buckets : The number of buckets of the hash table, a power of two
+     * @param keys : The full keys of the snapshot
+     * @param values : The values of the keys
+     */
+    static void layout(char *segment, size_t size, uint64_t generation, uint64_t buckets,
+                       const std::vector<std::string> &keys, const std::vector<const Value *> &values)
+    {
+        shared::Header *header = reinterpret_cast<shared::Header *>(segment);
+        shared::Entry *entries = reinterpret_cast<shared::Entry *>(header + 1);
+        uint64_t *table = reinterpret_cast<uint64_t *>(entries + keys.size());
+        uint64_t offset = sizeof(shared::Header) + keys.size() * sizeof(shared::Entry) + buckets * sizeof(uint64_t);
+
+        header->magic = shared::magic;
+        header->generation = generation;
+        header->count = keys.size();
+        header->buckets = buckets;
+        header->size = size;
+        memset(table, 0, buckets * sizeof(uint64_t));
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            shared::Entry &entry = entries[i];
+            uint64_t bucket;
+
+            entry.hash = Value::hash(keys[i].data(), keys[i].size());
+            entry.key = offset;
+            entry.keySize = keys[i].size();
+            memcpy(segment + offset, keys[i].data(), keys[i].size());
+            offset += keys[i].size();
+            entry.value = offset;
+            entry.valueSize = values[i]->size();
+            memcpy(segment + offset, values[i]->data(), values[i]->size());
+            offset += values[i]->size();
+            for (bucket = entry.hash & (buckets - 1); table[bucket] != 0; bucket = (bucket + 1) & (buckets - 1));
+            table[bucket] = i + 1; //0 marks an empty bucket
+        }
+    }
+
+    //
+    // MEMBERS
+    //
+
+    std::string _name;
+    size_t _size;
+    shared::Control *_control;
+
+private:
+    BasicConfigPublisher(const BasicConfigPublisher &);
+    BasicConfigPublisher &operator=(const BasicConfigPublisher &);
+};
+
+/*!
+ * @class BasicSharedConfig
+ * @brief Read-only view of a configuration published in shared memory
+ *
+ * Lookups are served straight from the mapped snapshot with a single hash probe, without parsing or copying.
+ * Every read checks the generation of the publication and maps the latest snapshot if it changed.
+ * When the publisher is withdrawn, the last snapshot stays readable until a new publisher of the same name publishes.
+ * A SharedConfig is not meant to be used by several threads at once, each thread should own its reader.
+ */
+template <typename Grammar = Syntax>
+class BasicSharedConfig
+{
+public:
+    /*! @brief Type of the configurations published */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*!
+     * @brief SharedConfig constructor
+     * @param name : The name of the publication to read
+     */
+    explicit BasicSharedConfig(const std::string &name) : _name(name), _controlSize(0),
+                                                          _header(NULL), _size(0), _generation(0), _missing(0), _instance(0)
+    {
+        _control = static_cast<shared::Control *>(shared::map(name, O_RDONLY, _controlSize));
+        if (_control == NULL) throw (std::runtime_error("undefined shared configuration: "+name));
+        if (_controlSize < sizeof(shared::Control) || _control->magic != shared::magic)
+        {
+            munmap(_control, _controlSize);
+            throw (std::runtime_error("invalid shared configuration: "+name));
+        }
+        _instance = _control->instance.load(std::memory_order_acquire);
+        refresh();
+    }
+
+    /*! @brief SharedConfig destructor */
+    ~BasicSharedConfig()
+    {
+        if (_header != NULL) munmap(const_cast<shared::Header *>(_header), _size);
+        munmap(_control, _controlSize);
+    }
+
+    /*!
+     * @brief Get the generation of the snapshot currently mapped
+     * @return The generation, 0 if nothing was published yet
+     */
+    uint64_t generation() const
+    {
+        return (_generation);
+    }
+
+    /*!
+     * @brief Map the latest snapshot if a new one was published.
+     * If the publisher was destroyed before the latest snapshot could be mapped, the current one is kept.
+     * @return true if the snapshot changed, false otherwise
+     */
+    bool refresh()
+    {
+        if (_control->instance.load(std::memory_order_acquire) != _instance && !reopen()) return (false);
+
+        uint64_t generation = _control->generation.load(std::memory_order_acquire), latest;
+
+        if (generation == _generation || generation == _missing) return (false);
+        while (generation != 0)
+        {
+            size_t size = 0;
+            void *segment = shared::map(shared::segment(_name, generation), O_RDONLY, size);
+
+            if (segment != NULL)
+            {
+                const shared::Header *header = static_cast<const shared::Header *>(segment);
+
+                if (size < sizeof(shared::Header) || header->magic != shared::magic || header->size > size)
+                {
+                    munmap(segment, size); //The current snapshot stays mapped
+                    throw (std::runtime_error("invalid shared configuration: "+_name));
+                }
+                if (_header != NULL) munmap(const_cast<shared::Header *>(_header), _size);
+                _header = header;
+                _size = size;
+                break;
+            }
+            else if (errno != ENOENT) throw (std::runtime_error("unable to open shared configuration: "+_name));
+            latest = _control->generation.load(std::memory_order_acquire);
+            if (latest == generation) //Removed without being superseded, the publisher is gone
+            {
+                _missing = generation;
+                return (false);
+            }
+            generation = latest; //Superseded before we opened it
+        }
+        _generation = generation;
+        return (true);
+    }
+
+    /*!
+     * @brief Get the number of keys in the snapshot
+     * @return The number of keys
+     */
+    size_t size()
+    {
+        refresh();
+        return (_header == NULL ? 0 : static_cast<size_t>(_header->count));
+    }
+
+    //
+    // GETTERS
+    //
+
+    /*!
+     * @brief Tests if a key exists in the snapshot
+     * @param key : The key to search for
+     * @return true if found, false if failed
+     */
+    bool exists(const std::string &key)
+    {
+        return (find(key) != NULL);
+    }
+
+    /*!
+     * @brief Get values from the snapshot
+     * @param key : The key identifying wanted value
+     * @param value : The variable to set with value
+     * @return true if found, false if failed
+     */
+    template <typename T>
+    bool get(const std::string &key, T &value)
+    {
+        const shared::Entry *entry = find(key);
+
+        if (entry == NULL) return (false);
+        config_type::convert(stored(*entry), value);
+        return (true);
+    }
+
+    /*!
+     * @brief Get C-style string values from the snapshot
+     * @param key : The key identifying wanted value
+     * @param value : The char array to set with value
+     * @return true if found, false if failed
+     */
+    bool get(const std::string &key, char *value)
+    {
+        const shared::Entry *entry = find(key);
+
+        if (entry == NULL) return (false);
+        config_type::convert(stored(*entry), value);
+        return (true);
+    }
+
+    /*!
+     * @brief Get pair values from the snapshot
+     * @param key : The key identifying wanted value
+     * @param pair : The pair to fill with values
+     * @return true if found, false if failed
+     */
+    template<typename Tx, typename Ty>
+    bool getPair(const std::string &key, std::pair<Tx, Ty> &pair)
+    {
+        const shared::Entry *entry = find(key);
+
+        if (entry == NULL) return (false);
+        return (config_type::convertPair(stored(*entry), pair));
+    }
+
+    /*!
+     * @brief Get container values from the snapshot
+     * @param key : The key identifying wanted container of values
+     * @param container : The container where the container of values will be pushed
+     * @return true if found, false if failed
+     */
+    template <typename T>
+    bool getContainer(const std::string &key, T &container)
+    {
+        const shared::Entry *entry = find(key);
+
+        if (entry == NULL) return (false);
+        config_type::convertContainer(stored(*entry), container);
+        return (true);
+    }
+
+protected:
+    /*!
+     * @brief Open the control segment of the current publisher, once the one mapped was withdrawn or taken over.
+     * Attempts are spaced by shared::retry, so that reads stay cheap while no publisher is running.
+     * @return true if a running publisher was found, false otherwise
+     */
+    bool reopen()
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        size_t size = 0;
+        shared::Control *control;
+
+        if (now < _retry) return (false);
+        _retry = now + std::chrono::milliseconds(shared::retry);
+        control = static_cast<shared::Control *>(shared::map(_name, O_RDONLY, size));
+        if (control == NULL) return (false);
+        if (size < sizeof(shared::Control) || control->magic != shared::magic || control->instance.load(std::memory_order_acquire) == 0)
+        {
+            munmap(control, size);
+            return (false);
+        }
+        munmap(_control, _controlSize);
+        _control = control;
+        _controlSize = size;
+        _instance = control->instance.load(std::memory_order_acquire);
+        _generation = 0; //Generations start over with a new publisher
+        _missing = 0;
+        return (true);
+    }
+
+    /*!
+     * @brief Find the entry of a key in the latest snapshot
+     * @param key : The key to search for
+     * @return The entry, NULL if the key is not published
+     */
+    const shared::Entry *find(const std::string &key)
+    {
+        refresh();
+        if (_header == NULL || _header->count == 0) return (NULL);
+
+        const char *segment = reinterpret_cast<const char *>(_header);
+        const shared::Entry *entries = reinterpret_cast<const shared::Entry *>(_header + 1);
+        const uint64_t *table = reinterpret_cast<const uint64_t *>(entries + _header->count);
+        uint64_t hash = Value::hash(key.data(), key.size());
+
+        for (uint64_t bucket = hash & (_header->buckets - 1); table[bucket] != 0; bucket = (bucket + 1) & (_header->buckets - 1))
+        {
+            const shared::Entry &entry = entries[table[bucket] - 1];
+
+            if (entry.hash == hash && entry.keySize == key.size() && memcmp(segment + entry.key, key.data(), key.size()) == 0)
+            {
+                return (&entry);
+            }
+        }
+        return (NULL);
+    }
+
+    /*!
+     * @brief Get the value of an entry without copying it
+     * @param entry : The entry to read
+     * @return A value referencing the mapped characters
+     */
+    Value stored(const shared::Entry &entry) const
+    {
+        return (Value::borrow(reinterpret_cast<const char *>(_header) + entry.value, static_cast<size_t>(entry.valueSize)));
+    }
+
+    //
+    // MEMBERS
+    //
+
+    std::string _name;
+    size_t _controlSize;
+    shared::Control *_control;
+    const shared::Header *_header;
+    size_t _size;
+    uint64_t _generation;
+    uint64_t _missing;
+    uint64_t _instance;
+    std::chrono::steady_clock::time_point _retry;
+
+private:
+    BasicSharedConfig(const BasicSharedConfig &);
+    BasicSharedConfig &operator=(const BasicSharedConfig &);
+};
+
+/*! @brief Config publisher using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicConfigPublisher<> ConfigPublisher;
+/*! @brief Shared config reader using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicSharedConfig<> SharedConfig;
+
+}
+
+#endif /* !TINYCONF_SHARED_HPP_ */
@@ -0,0 +1,325 @@
+#ifndef TINYCONF_STACK_HPP_
+#define TINYCONF_STACK_HPP_
+
+/*! * * * * * * * * * * * * * * * * * * * *
+ * TinyConf Library
+ * @version 0.1
+ * @file tinyconf.stack.hpp
+ * @author Maxime 'Stalker2106' Martens
+ * @brief Additional header for layered configurations
+ * * * * * * * * * * * * * * * * * * * * */
+
+#include <deque>
+#include <unordered_map>
+
+#include "tinyconf.hpp"
+
+/* Everything is defined within stb:: scope */
+namespace stb {
+
+/*!
+ * @class BasicConfigStack
+ * @brief Ordered stack of configurations resolved as a single one
+ *
+ * Layers are pushed from the lowest priority (defaults) to the highest (runtime overrides).
+ * The stack keeps a flattened index of the winning value of every key, updated on each change,
+ * so that reading a key costs a single hash lookup whatever the number of layers.
+ * Only keys stored in a layer are stacked, built-in defaults of a layer (see BasicConfig::setDefaults()) are not.
+ */
+template <typename Grammar = Syntax>
+class BasicConfigStack
+{
+public:
+    /*! @brief Type of the configurations stacked */
+    typedef BasicConfig<Grammar> config_type;
+
+    /*! @brief Value returned by origin() when no layer defines the key */
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /*! @brief ConfigStack empty constructor */
+    BasicConfigStack() {}
+
+    //
+    // LAYERS MANAGEMENT
+    //
+
+    /*!
+     * @brief Push a configuration on top of the stack (highest priority)
+     * @param layer : The configuration to push
+     * @return the index of the new layer
+     */
+    size_t push(const config_type &layer)
+    {
+        _layers.push_back(layer);
+        index(_layers.size() - 1);
+        return (_layers.size() - 1);
+    }
+
+    /*!
+     * @brief Load a configuration file on top of the stack (highest priority)
+     * @param path : The path to the configuration file to push
+     * @return the index of the new layer
+     */
+    size_t push(const std::string &path)
+    {
+        return (push(config_type(path)));
+    }
+
+    /*!
+     * @brief Remove the top layer of the stack
+     */
+    void pop()
+    {
+        if (_layers.empty()) throw (std::runtime_error("empty stack")); //Nothing to pop !
+        _layers.pop_back();
+        reindex();
+    }
+
+    /*!
+     * @brief Get the number of layers in the stack
+     * @return The number of layers
+     */
+    size_t size() const
+    {
+        return (_layers.size());
+    }
+
+    /*!
+     * @brief Get a layer of the stack
+     * @param layer : The index of the layer
+     * @return The configuration of the layer
+     */
+    const config_type &layer(size_t layer) const
+    {
+        return (_layers.at(layer));
+    }
+
+    /*!
+     * @brief Reload a layer from its associated file
+     * @param layer : The index of the layer to reload
+     */
+    void reload(size_t layer)
+    {
+        _layers.at(layer).reload();
+        reindex();
+    }
+
+    //
+    // GETTERS
+    //
+
+    /*!
+     * @brief Tests if a key exists in any layer
+     * @param key : The key to search for
+     * @return true if found, false if failed
+     */
+    bool exists(const std::string &key) const
+    {
+        return (_index.find(key) != _index.end());
+    }
+
+    /*!
+     * @brief Get the layer that supplies the value of a key
+     * @param key : The key to search for
+     * @return The index of the winning layer, npos if no layer defines the key
+     */
+    size_t origin(const std::string &key) const
+    {
+        typename resolved_map::const_iterator it = _index.find(key);
+
+        if (it == _index.end()) return (npos);
+        return (it->second.layer);
+    }
+
+    /*!
+     * @brief Get resolved values from the stack
+     * @param key : The key identifying wanted value
+     * @param value : The variable to set with value
+     * @return true if found, false if failed
+     */
+    template <typename T>
+    bool get(const std::string &key, T &value) const
+    {
+        typename resolved_map::const_iterator it = _index.find(key);
+
+        if (it == _index.end()) return (false);
+        config_type::convert(it->second.value, value);
+        return (true);
+    }
+
+    /*!
+     * @brief Get C-style string resolved values from the stack
+     * @param key : The key identifying wanted value
+     * @param value : The char array to set with value
+     * @return true if found, false if failed
+     */
+    bool get(const std::string &key, char *value) const
+    {
+        typename resolved_map::const_iterator it = _index.find(key);
+
+        if (it == _index.end()) return (false);
+        config_type::convert(it->second.value, value);
+        return (true);
+    }
+
+    /*!
+     * @brief Get pair resolved values from the stack
+     * @param key : The key identifying wanted value
+     * @param pair : The pair to fill with values
+     * @return true if found, false if failed
+     */
+    template<typename Tx, typename Ty>
+    bool getPair(const std::string &key, std::pair<Tx, Ty> &pair) const
+    {
+        typename resolved_map::const_iterator it = _index.find(key);
+
+        if (it == _index.end()) return (false);
+        return (config_type::convertPair(it->second.value, pair));
+    }
+
+    /*!
+     * @brief Get container resolved values from the stack
+     * @param key : The key identifying wanted container of values
+     * @param container : The container where the container of values will be pushed
+     * @return true if found, false if failed
+     */
+    template <typename T>
+    bool getContainer(const std::string &key, T &container) const
+    {
+        typename resolved_map::const_iterator it = _index.find(key);
+
+        if (it == _index.end()) return (false);
+        config_type::convertContainer(it->second.value, container);
+        return (true);
+    }
+
+    //
+    // SETTERS
+    //
+
+    /*!
+     * @brief Set a value inside a given layer
+     * @param layer : The index of the layer to modify
+     * @param key : The key indentifier to set
+     * @param value : The value to set in key field
+     */
+    template <typename T>
+    void set(size_t layer, const std::string &key, const T &value)
+    {
+        config_type &target = _layers.at(layer);
+
+        target.set(key, value);
+        resolve(key, layer);
+        resolve(target.dependents(key), layer);
+    }
+
+    /*!
+     * @brief Erase a key from a given layer
+     * @param layer : The index of the layer to modify
+     * @param key : The key to erase
+     */
+    void erase(size_t layer, const std::string &key)
+    {
+        _layers.at(layer).erase(key);
+        resolve(key, layer);
+        resolve(_layers[layer].dependents(key), layer);
+    }
+
+protected:
+    /*! @brief Winning value of a key */
+    struct resolved
+    {
+        size_t layer;
+        Value value;
+    };
+    /*! @brief Container used to store the flattened view */
+    typedef std::unordered_map<std::string, resolved> resolved_map;
+
+    /*!
+     * @brief Register every key of a layer pushed on top of the stack
+     * @param layer : The index of the layer
+     */
+    void index(size_t layer)
+    {
+        std::shared_ptr<const typename config_type::section_map> config = _layers[layer].view(); //Rebuilt from the table of frozen layers
+
+        for (typename config_type::section_map::const_iterator section = config->begin(); section != config->end(); section++)
+        {
+            for (typename config_type::association_map::const_iterator it = section->second->begin(); it != section->second->end(); it++)
+            {
+                resolved &entry = _index[config_type::join(section->first, it->first)];
+
+                entry.layer = layer;
+                entry.value = it->second;
+            }
+        }
+    }
+
+    /*!
+     * @brief Rebuild the whole flattened view
+     */
+    void reindex()
+    {
+        _index.clear();
+        for (size_t layer = 0; layer < _layers.size(); layer++)
+        {
+            index(layer);
+        }
+    }
+
+    /*!
+     * @brief Update the flattened view after a key changed in a layer
+     * @param key : The key that changed
+     * @param layer : The layer where it changed
+     */
+    void resolve(const std::string &key, size_t layer)
+    {
+        typename resolved_map::iterator it = _index.find(key);
+
+        if (it != _index.end() && it->second.layer > layer) return; //Hidden by an upper layer
+        for (size_t i = layer + 1; i-- > 0;)
+        {
+            const Value *value = _layers[i].lookup(key); //Stored keys only, as index() walks them
+
+            if (value != NULL)
+            {
+                resolved &entry = _index[key];
+
+                entry.layer = i;
+                entry.value = *value;
+                return;
+            }
+        }
+        if (it != _index.end()) _index.erase(it);
+    }
+
+    /*!
+     * @brief Update the flattened view after keys were expanded again in a layer
+     * @param keys : The keys expanded again
+     * @param layer : The layer where they changed
+     */
+    void resolve(const std::vector<std::string> &keys, size_t layer)
+    {
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            resolve(keys[i], layer);
+        }
+    }
+
+    //
+    // MEMBERS
+    //
+
+    std::deque<config_type> _layers;
+    resolved_map _index;
+};
+
+template <typename Grammar>
+const size_t BasicConfigStack<Grammar>::npos;
+
+/*! @brief Config stack using the default grammar, defined in tinyconf.config.hpp */
+typedef BasicConfigStack<> ConfigStack;
+
+}
+
+#endif /* !TINYCONF_STACK_HPP_ */
@@ -1,4 +1,11 @@
 #include "../include/tinyconf/tinyconf.hpp"
+#include "../include/tinyconf/tinyconf.stack.hpp"
+#include "../include/tinyconf/tinyconf.set.hpp"
+#include "../include/tinyconf/tinyconf.shared.hpp"
+#include "../include/tinyconf/tinyconf.embed.hpp"
+#include "../include/tinyconf/tinyconf.bind.hpp"
+#include "../include/tinyconf/tinyconf.patch.hpp"
+#include "../include/tinyconf/tinyconf.schema.hpp"
 
 #include <iostream>
 #include <deque>
@@ -80,6 +87,36 @@ void basic_tests()
     test.destroy();
 }
 
+void sections_tests()
+{
+    std::string buffer;
+
+    stb::Config::destroy("./sections.cfg");
+    stb::Config test("./sections.cfg");
+
+    std::cout << "Nested separators => ";
+    test.set("Tenant1234:limits:rate", 10);
+    test.set("Tenant1234:name", "tenant");
+    test.set("Escaped\\:Root", "root");
+    test.save();
+    test.reload();
+    test.get("Tenant1234:limits:rate", buffer);
+    std::cout << (buffer == "10" && test.exists("Escaped\\:Root") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Updating value in file => ";
+    test.set("Tenant1234:name", "renamed");
+    test.save();
+    test.reload();
+    test.get("Tenant1234:name", buffer);
+    std::cout << (buffer == "renamed" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Erasing last key of section => ";
+    test.erase("Tenant1234:name");
+    test.erase("Tenant1234:limits:rate");
+    std::cout << (!test.exists("Tenant1234:name") && test.exists("Escaped\\:Root") ? "OK" : "FAIL") << "\n";
+    test.destroy();
+}
+
 void primitives_tests(stb::Config &test)
 {
     char *sCharstr = new char[3], charstr[] = "ISOK";
@@ -173,6 +210,28 @@ void containers_tests(stb::Config &test)
     std::cout << "Pair Test => ";
     test.getPair("PairTest", sPair);
     std::cout << (sPair.first == pair.first && sPair.second == pair.second ? "OK" : "FAIL") << "\n";
+
+    std::vector<float> sFloats, floats;
+    stb::PackedView<float> view;
+    std::string text;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        floats.push_back(i * 0.5f);
+    }
+    std::cout << "Packed container Test => ";
+    test.setContainer("PackedTest", floats);
+    test.getContainer("PackedTest", sFloats);
+    test.getView("PackedTest", view);
+    test.get("PackedTest", text);
+    std::cout << (sFloats == floats && view.size() == 1000 && view[10] == 5.0f && text.compare(0, 8, "0:0.5:1:") == 0 ? "OK" : "FAIL") << "\n";
+
+    stb::PackedView<int> ints;
+    sVectori.clear();
+    std::cout << "View over text Test => ";
+    test.getView("VectorTest", ints);
+    test.getContainer("VectorTest", sVectori);
+    std::cout << (ints.size() == 3 && ints[2] == 3 && sVectori == vectori ? "OK" : "FAIL") << "\n";
 }
 
 void comments_tests(stb::Config &test)
@@ -214,11 +273,776 @@ void comments_tests(stb::Config &test)
     std::cout << (iak == "but this is not" ? "OK" : "FAIL") << "\n";
 }
 
+struct DashDialect : stb::Syntax
+{
+    static constexpr const char *keyValueSeparator() { return ("@"); }
+    static constexpr const char *valueFieldSeparator() { return ("-"); }
+};
+
+void syntax_tests()
+{
+    std::vector<int> sVector, vector = {1, 2, 3};
+    std::string line;
+
+    stb::Config::destroy("./dialect.cfg");
+    stb::BasicConfig<DashDialect> dialect("./dialect.cfg");
+
+    std::cout << "Custom dialect writing => ";
+    dialect.setContainer("MyKeyArray", vector);
+    dialect.save();
+    std::ifstream file("./dialect.cfg");
+    std::getline(file, line);
+    file.close();
+    std::cout << (line == "MyKeyArray@1-2-3" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Custom dialect reading => ";
+    dialect.reload();
+    dialect.getContainer("MyKeyArray", sVector);
+    std::cout << (sVector == vector ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Default dialect alongside => ";
+    stb::Config ini("./dialect.cfg");
+    std::cout << (!ini.exists("MyKeyArray") ? "OK" : "FAIL") << "\n";
+    dialect.destroy();
+}
+
+void stack_tests()
+{
+    stb::ConfigStack stack;
+    stb::Config defaults, overrides;
+    std::string buffer;
+    int value = 0;
+
+    defaults.set("Net:Port", 80);
+    defaults.set("Net:Host", "localhost");
+    overrides.set("Net:Port", 8080);
+    stack.push(defaults);
+    stack.push(overrides);
+
+    std::cout << "Resolving overridden key => ";
+    stack.get("Net:Port", value);
+    std::cout << (value == 8080 && stack.origin("Net:Port") == 1 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Resolving inherited key => ";
+    stack.get("Net:Host", buffer);
+    std::cout << (buffer == "localhost" && stack.origin("Net:Host") == 0 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Erasing override => ";
+    stack.erase(1, "Net:Port");
+    stack.get("Net:Port", value);
+    std::cout << (value == 80 && stack.origin("Net:Port") == 0 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Setting inside hidden layer => ";
+    stack.set(1, "Net:Host", "example.org");
+    stack.set(0, "Net:Host", "127.0.0.1");
+    stack.get("Net:Host", buffer);
+    std::cout << (buffer == "example.org" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Popping layer => ";
+    stack.pop();
+    stack.get("Net:Host", buffer);
+    std::cout << (buffer == "127.0.0.1" && stack.origin("Unknown") == stb::ConfigStack::npos ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Resolving dependent keys => ";
+    stack.set(0, "Paths:Root", "/opt");
+    stack.set(0, "Paths:Bin", "${Paths:Root}/bin");
+    stack.set(0, "Paths:Root", "/usr");
+    stack.get("Paths:Bin", buffer);
+    std::cout << (buffer == "/usr/bin" ? "OK" : "FAIL") << "\n";
+}
+
+void interpolation_tests()
+{
+    std::string buffer, line;
+
+    stb::Config::destroy("./interpolation.cfg");
+    stb::Config test("./interpolation.cfg");
+    setenv("TINYCONF_TEST_ENV", "env", 1);
+
+    std::cout << "Expanding key reference => ";
+    test.set("Paths:Root", "/opt");
+    test.set("Paths:Bin", "${Paths:Root}/bin");
+    test.get("Paths:Bin", buffer);
+    std::cout << (buffer == "/opt/bin" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Expanding environment variable => ";
+    test.set("EnvKey", "${TINYCONF_TEST_ENV}:\\${Escaped}");
+    test.get("EnvKey", buffer);
+    std::cout << (buffer == "env:\\${Escaped}" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Updating dependents => ";
+    test.set("Paths:Lib", "${Paths:Bin}/../lib");
+    test.set("Paths:Root", "/usr");
+    test.get("Paths:Lib", buffer);
+    std::cout << (buffer == "/usr/bin/../lib" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Saving references unexpanded => ";
+    test.save();
+    std::ifstream file("./interpolation.cfg");
+    while (std::getline(file, line) && line.find("Bin=") != 0);
+    file.close();
+    std::cout << (line == "Bin=${Paths:Root}/bin" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Copying references => ";
+    stb::Config copy(test);
+    std::string copied;
+    copy.set("Paths:Root", "/opt");
+    copy.get("Paths:Lib", copied);
+    test.get("Paths:Lib", buffer);
+    std::cout << (copied == "/opt/bin/../lib" && buffer == "/usr/bin/../lib" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Detecting cycles => ";
+    std::ofstream cycle("./interpolation.cfg", std::ofstream::out | std::ofstream::trunc);
+    cycle << "A=${B}\nB=${C}\nC=${A}\n";
+    cycle.close();
+    test.reload();
+    std::cout << (test.errors().size() == 1 && test.errors()[0].key == "C" && test.exists("A") && !test.exists("C") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Keeping unresolved references => ";
+    test.set("Unresolved", "${TINYCONF_UNDEFINED}/bin");
+    test.get("Unresolved", buffer);
+    std::cout << (buffer == "${TINYCONF_UNDEFINED}/bin" ? "OK" : "FAIL") << "\n";
+    test.destroy();
+}
+
+void async_tests()
+{
+    std::promise<std::exception_ptr> done;
+    std::string buffer;
+
+    stb::Config::destroy("./async.cfg");
+    stb::Config test("./async.cfg");
+
+    std::cout << "Saving asynchronously => ";
+    test.set("AsyncKey", "Saved");
+    std::future<void> saved = test.saveAsync();
+    test.set("AsyncKey", "Modified");
+    saved.get();
+    stb::Config check("./async.cfg");
+    check.get("AsyncKey", buffer);
+    std::cout << (buffer == "Saved" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Reloading asynchronously => ";
+    test.reloadAsync().get();
+    test.get("AsyncKey", buffer);
+    std::cout << (buffer == "Saved" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Loading with callback => ";
+    stb::Config callback;
+    callback.setPath("./async.cfg");
+    callback.loadAsync([&done](std::exception_ptr error) { done.set_value(error); });
+    std::exception_ptr error = done.get_future().get();
+    std::cout << (!error && callback.exists("AsyncKey") ? "OK" : "FAIL") << "\n";
+    test.destroy();
+}
+
+void set_tests()
+{
+    std::vector<std::string> paths;
+    std::string buffer;
+    int value = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        std::ofstream file("./fragment" + std::to_string(i) + ".cfg");
+        file << "/* Fragment\n*/\n[Service" << i << "]\nId=" << i << "\n";
+        file << "[Shared]\nLast=" << i << "\n";
+    }
+
+    std::cout << "Loading directory in parallel => ";
+    stb::ConfigSet set;
+    set.load(".", ".cfg", 4);
+    std::vector<std::string> listed = stb::ConfigSet::list(".");
+    std::cout << (set.size() == listed.size() && set.size() >= 8 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Merging set => ";
+    stb::Config merged = set.merge();
+    merged.get("Service5:Id", value);
+    merged.get("Shared:Last", buffer);
+    std::cout << (value == 5 && buffer == "7" ? "OK" : "FAIL") << "\n";
+
+    for (int i = 0; i < 8; i++)
+    {
+        stb::Config::destroy("./fragment" + std::to_string(i) + ".cfg");
+    }
+}
+
+void memory_tests()
+{
+    stb::Config test;
+    std::string host = "a-rather-long-hostname.example.org", buffer;
+
+    for (int i = 0; i < 100; i++)
+    {
+        test.set("Hosts:Host" + std::to_string(i), host);
+    }
+    stb::MemoryReport before = test.memoryUsage();
+
+    std::cout << "Compacting with interning => ";
+    test.setInterning(true);
+    test.compact();
+    stb::MemoryReport after = test.memoryUsage();
+    test.get("Hosts:Host42", buffer);
+    std::cout << (after.values == 1 && after.sharedBytes == 99 * host.size() && after.total < before.total && buffer == host ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Interning new values => ";
+    test.set("Hosts:Other", host);
+    test.set("Hosts:Host0", "changed");
+    std::cout << (test.memoryUsage().values == 2 ? "OK" : "FAIL") << "\n";
+}
+
+size_t count(const stb::Config::key_range &range)
+{
+    size_t count = 0;
+
+    for (stb::Config::const_iterator it = range.begin(); it != range.end(); it++)
+    {
+        count++;
+    }
+    return (count);
+}
+
+void iteration_tests()
+{
+    stb::Config test;
+    std::string buffer;
+
+    test.set("Name", "test");
+    test.set("Other", "value");
+    test.set("Net:Host", "localhost");
+    test.set("Net:Port", 8080);
+    test.set("Network:Mode", "bridge");
+    test.set("Web:Port", 80);
+
+    std::cout << "Iterating over a section => ";
+    stb::Config::key_range net = test.prefix("Net:");
+    stb::Config::const_iterator it = net.begin();
+    it->get(buffer);
+    std::cout << (count(net) == 2 && it->section() == "Net" && it->key() == "Host" && it->name() == "Net:Host" && buffer == "localhost" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Iterating over a prefix => ";
+    std::cout << (count(test.prefix("Net")) == 3 && count(test.prefix("N")) == 4 && count(test.prefix("")) == 6 && test.prefix("Nope").empty() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Iterating between keys => ";
+    std::cout << (count(test.between("Net:Port", "Web:Port")) == 2 && test.between("Web:Port", "Net:Port").empty() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Iterating while modifying => ";
+    stb::Config::key_range all = test.keys();
+    test.set("Net:User", "admin");
+    test.erase("Web:Port");
+    std::cout << (count(all) == 6 && count(test.keys()) == 6 && count(test.prefix("Net:")) == 3 ? "OK" : "FAIL") << "\n";
+}
+
+void freeze_tests()
+{
+    stb::Config test;
+    std::vector<std::thread> readers;
+    std::atomic<int> failures(0);
+    std::string buffer;
+    int value = 0;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        test.set("Keys:Key" + std::to_string(i), i);
+    }
+    test.set("Name", "frozen");
+    test.set("Paths:Root", "/opt");
+    test.set("Paths:Bin", "${Paths:Root}/bin");
+    test.freeze();
+
+    std::cout << "Reading frozen configuration => ";
+    test.get("Keys:Key420", value);
+    test.get("Name", buffer);
+    std::cout << (test.frozen() && value == 420 && buffer == "frozen" && !test.exists("Keys:Key1000") && !test.exists("Key1") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Reading frozen configuration concurrently => ";
+    for (int t = 0; t < 4; t++)
+    {
+        readers.push_back(std::thread([&test, &failures]() {
+            int read = 0;
+
+            for (int i = 0; i < 1000; i++)
+            {
+                if (!test.get("Keys:Key" + std::to_string(i), read) || read != i) failures++;
+            }
+        }));
+    }
+    for (size_t t = 0; t < readers.size(); t++) readers[t].join();
+    std::cout << (failures == 0 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Iterating frozen configuration => ";
+    stb::MemoryReport report = test.memoryUsage();
+    std::cout << (count(test.keys()) == 1003 && count(test.prefix("Paths:")) == 2 && report.keys == 1003 && report.sections == 3
+                  && test.dependents("Paths:Root").size() == 1 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Modifying frozen configuration => ";
+    bool rejected = false;
+    try {
+        test.set("Name", "thawed");
+    }
+    catch (std::runtime_error &) {
+        rejected = true;
+    }
+    test.thaw();
+    test.set("Name", "thawed");
+    test.get("Name", buffer);
+    std::cout << (rejected && !test.frozen() && buffer == "thawed" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Thawing references => ";
+    test.set("Paths:Root", "/usr");
+    test.get("Paths:Bin", buffer);
+    test.get("Keys:Key420", value);
+    std::cout << (buffer == "/usr/bin" && value == 420 && count(test.keys()) == 1003 ? "OK" : "FAIL") << "\n";
+}
+
+void copy_tests()
+{
+    stb::Config original;
+    int value = 0;
+
+    original.set("Server:Port", 8080);
+    original.set("Client:Port", 9090);
+    stb::Config copy = original;
+
+    std::cout << "Writing to a copy => ";
+    copy.set("Server:Port", 1234);
+    copy.erase("Client:Port");
+    original.get("Server:Port", value);
+    std::cout << (value == 8080 && original.exists("Client:Port") && !copy.exists("Client:Port") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Writing to the original => ";
+    original.set("Server:Host", "localhost");
+    copy.get("Server:Port", value);
+    std::cout << (value == 1234 && !copy.exists("Server:Host") && original.exists("Server:Host") ? "OK" : "FAIL") << "\n";
+}
+
+void shared_tests()
+{
+    std::string name = "/tinyconf-test-" + std::to_string(getpid()), buffer;
+    stb::ConfigPublisher publisher(name);
+    stb::Config test;
+    int port = 0;
+
+    test.set("Server:Host", "localhost");
+    test.set("Server:Port", 8080);
+    publisher.publish(test);
+    stb::SharedConfig reader(name);
+
+    std::cout << "Reading published configuration => ";
+    reader.get("Server:Host", buffer);
+    reader.get("Server:Port", port);
+    std::cout << (reader.size() == 2 && buffer == "localhost" && port == 8080 && !reader.exists("Server:User") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Reading republished configuration => ";
+    test.set("Server:Port", 9090);
+    test.set("Server:User", "admin");
+    publisher.publish(test);
+    reader.get("Server:Port", port);
+    std::cout << (reader.generation() == 2 && port == 9090 && reader.exists("Server:User") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Outliving the publisher => ";
+    std::unique_ptr<stb::ConfigPublisher> transient(new stb::ConfigPublisher(name + "-transient"));
+    transient->publish(test);
+    stb::SharedConfig orphan(name + "-transient");
+    test.set("Server:Port", 7070);
+    transient->publish(test);
+    transient.reset(); //Latest snapshot removed before the reader mapped it
+    orphan.get("Server:Port", port);
+    std::cout << (orphan.generation() == 1 && port == 9090 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Following a restarted publisher => ";
+    transient.reset(new stb::ConfigPublisher(name + "-transient"));
+    transient->publish(test);
+    std::this_thread::sleep_for(std::chrono::milliseconds(stb::shared::retry)); //The withdrawal was noticed by the last read
+    orphan.get("Server:Port", port);
+    std::cout << (orphan.generation() == 1 && port == 7070 ? "OK" : "FAIL") << "\n";
+    transient.reset();
+
+    std::cout << "Publishing expanded values => ";
+    test.set("Paths:Root", "/opt");
+    test.set("Paths:Bin", "${Paths:Root}/bin");
+    publisher.publish(test);
+    reader.get("Paths:Bin", buffer);
+    std::cout << (buffer == "/opt/bin" ? "OK" : "FAIL") << "\n";
+}
+
+TINYCONF_EMBED(EmbeddedDefaults, "Name=default\n"
+                                  "# Built-in values\n"
+                                  "[Server]\n"
+                                  "Port=8080\n"
+                                  "Host=localhost\n"
+                                  "Port=8181\n");
+TINYCONF_EMBED(EmbeddedSeparators, "Filter=name=value\n"
+                                    "Url\\:Port=80\n");
+
+void embed_tests()
+{
+    stb::Config::destroy("./embed.cfg");
+    stb::Config test("./embed.cfg");
+    std::string buffer;
+    int port = 0;
+
+    std::cout << "Reading embedded configuration => ";
+    const stb::Value *host = EmbeddedDefaults::find("Server:Host");
+    std::cout << (EmbeddedDefaults::size() == 4 && host != NULL && host->str() == "localhost" && EmbeddedDefaults::find("Server:User") == NULL ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Falling back on embedded defaults => ";
+    test.setDefaults<EmbeddedDefaults>();
+    test.set("Name", "custom");
+    test.get("Name", buffer);
+    test.get("Server:Port", port);
+    std::cout << (buffer == "custom" && port == 8181 && test.exists("Server:Host") && !test.exists("Server:User") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Saving without embedded defaults => ";
+    test.save();
+    stb::Config reloaded("./embed.cfg");
+    std::cout << (reloaded.exists("Name") && !reloaded.exists("Server:Port") ? "OK" : "FAIL") << "\n";
+    stb::Config::destroy("./embed.cfg");
+
+    std::cout << "Stacking layers with embedded defaults => ";
+    stb::ConfigStack stack;
+    stb::Config layer;
+    layer.setDefaults<EmbeddedDefaults>();
+    stack.push(layer);
+    bool pushed = !stack.exists("Server:Host");
+    stack.set(0, "Server:Host", "example.org");
+    stack.erase(0, "Server:Host");
+    std::cout << (pushed && !stack.exists("Server:Host") && stack.origin("Server:Host") == stb::ConfigStack::npos ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Splitting embedded lines as loaded ones => ";
+    std::ofstream("./embed.cfg") << EmbeddedSeparatorsSource::text();
+    stb::Config parsed("./embed.cfg");
+    const stb::Value *filter = EmbeddedSeparators::find("Filter=name");
+    parsed.get("Filter=name", buffer);
+    std::cout << (filter != NULL && filter->str() == "value" && buffer == "value" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Finding escaped embedded separators => ";
+    const stb::Value *url = EmbeddedSeparators::find("Url\\:Port");
+    parsed.get("Url\\:Port", buffer);
+    std::cout << (url != NULL && url->str() == "80" && buffer == "80" ? "OK" : "FAIL") << "\n";
+    stb::Config::destroy("./embed.cfg");
+}
+
+void version_tests()
+{
+    stb::Config test;
+    uint64_t name, port, epoch;
+
+    test.set("Name", "first");
+    test.set("Server:Port", 8080);
+    name = test.version("Name");
+    port = test.version("Server:Port");
+    epoch = test.epoch();
+
+    std::cout << "Versioning set keys => ";
+    std::cout << (name != 0 && port > name && epoch == port && test.version("Server:User") == 0 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Versioning modified keys => ";
+    test.set("Name", "second");
+    std::cout << (test.version("Name") > epoch && test.version("Server:Port") == port && test.epoch() > epoch ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Versioning erased and moved keys => ";
+    epoch = test.epoch();
+    test.move("Server:Port", "Server:Listen");
+    test.compact();
+    std::cout << (test.version("Server:Port") == 0 && test.version("Server:Listen") > epoch && test.epoch() == test.version("Server:Listen") ? "OK" : "FAIL") << "\n";
+}
+
+void transaction_tests()
+{
+    stb::Config test;
+    std::string buffer;
+    uint64_t epoch;
+
+    test.set("Name", "before");
+    test.set("Server:Port", 8080);
+    epoch = test.epoch();
+
+    std::cout << "Committing a transaction => ";
+    stb::Transaction tx = test.begin();
+    tx.set("Name", "after").set("Server:Host", "localhost").erase("Server:Port");
+    bool isolated = !test.exists("Server:Host") && test.exists("Server:Port");
+    tx.commit();
+    test.get("Name", buffer);
+    std::cout << (isolated && buffer == "after" && test.exists("Server:Host") && !test.exists("Server:Port")
+                  && test.version("Name") == test.version("Server:Host") && test.epoch() == test.version("Name") && test.epoch() > epoch ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Rolling back a failed transaction => ";
+    epoch = test.epoch();
+    stb::Transaction failed = test.begin();
+    bool rejected = false;
+    try {
+        failed.set("Name", "lost");
+        failed.erase("Server:Missing");
+        failed.commit();
+    }
+    catch (std::runtime_error &) {
+        rejected = true;
+        failed.rollback();
+    }
+    test.get("Name", buffer);
+    std::cout << (rejected && !failed.open() && buffer == "after" && test.epoch() == epoch ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Moving keys atomically => ";
+    test.move("Name", "Server:Name");
+    std::cout << (!test.exists("Name") && test.version("Server:Name") == test.epoch() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Keeping settings changed during a transaction => ";
+    stb::Transaction settings = test.begin();
+    settings.set("Name", "kept");
+    test.setPath("./transaction.cfg");
+    settings.commit();
+    stb::Transaction frozen = test.begin();
+    frozen.set("Name", "frozen");
+    test.freeze();
+    bool refused = false;
+    try {
+        frozen.commit();
+    }
+    catch (std::runtime_error &) {
+        refused = true;
+    }
+    test.get("Name", buffer);
+    std::cout << (test.getPath() == "./transaction.cfg" && buffer == "kept" && refused && test.frozen() ? "OK" : "FAIL") << "\n";
+}
+
+void mapping_tests()
+{
+    stb::Config::destroy("./mapped.cfg");
+    stb::Config source("./mapped.cfg"), mapped;
+    std::string buffer;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        source.set("Keys:Key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    source.set("Quoted", "\"quoted value\"");
+    source.save();
+    mapped.setMapping(true);
+    mapped.relocate("./mapped.cfg");
+    stb::Config parsed("./mapped.cfg");
+
+    std::cout << "Loading mapped file => ";
+    mapped.get("Keys:Key420", buffer);
+    std::cout << (buffer == "value420" && stb::Patch::diff(parsed, mapped).empty() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Saving mapped file => ";
+    mapped.set("Keys:Key1", "modified");
+    mapped.save();
+    mapped.get("Keys:Key999", buffer);
+    stb::Config reloaded("./mapped.cfg");
+    std::string modified;
+    reloaded.get("Keys:Key1", modified);
+    std::cout << (buffer == "value999" && modified == "modified" && reloaded.exists("Keys:Key999") ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Rewriting a mapped file => ";
+    std::ofstream("./mapped.cfg") << "A=short\nB=value\n";
+    stb::Config other("./mapped.cfg"), unmapped;
+    std::string first, second;
+    mapped.relocate("./mapped.cfg");
+    unmapped.setMapping(true);
+    unmapped.relocate("./mapped.cfg");
+    unmapped.setMapping(false);
+    unmapped.set("A", "a_much_longer_value");
+    unmapped.save();
+    other.set("A", "another_longer_value");
+    other.save(); //Written while mapped still references the file
+    unmapped.get("B", first);
+    mapped.get("B", second);
+    std::cout << (first == "value" && second == "value" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Diffing values of a mapped file => ";
+    std::ofstream("./mapped.cfg") << "X=one\nY=two\n";
+    mapped.relocate("./mapped.cfg");
+    stb::Config changed = mapped;
+    changed.set("X", mapped.prefix("Y").begin()->value()); //Another slice of the same mapping
+    std::cout << (stb::Patch::diff(mapped, changed).size() == 1 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Mapping values holding slashes => ";
+    std::ofstream("./mapped.cfg") << "Path=/usr/bin\nUrl=http://host/index\n";
+    mapped.relocate("./mapped.cfg");
+    std::cout << (mapped.prefix("Path").begin()->value().allocated() == 0 && mapped.prefix("Url").begin()->value().allocated() == 0 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Rewriting unmapped files in place => ";
+    struct stat before, after, linked;
+    std::ofstream("./plain.cfg") << "A=1\n";
+    chmod("./plain.cfg", 0600);
+    link("./plain.cfg", "./plain.link");
+    stat("./plain.cfg", &before);
+    stb::Config plain("./plain.cfg");
+    plain.set("A", 2);
+    plain.save(); //While mapped.cfg is still mapped
+    stat("./plain.cfg", &after);
+    stat("./plain.link", &linked);
+    std::cout << (stb::Value::mapped("./mapped.cfg") && !stb::Value::mapped("./plain.cfg") && after.st_ino == before.st_ino
+                  && linked.st_ino == after.st_ino && (after.st_mode & 0777) == 0600 ? "OK" : "FAIL") << "\n";
+    stb::Config::destroy("./plain.link");
+    stb::Config::destroy("./plain.cfg");
+    stb::Config::destroy("./mapped.cfg");
+}
+
+void schema_tests()
+{
+    stb::Schema schema;
+    stb::Config test;
+    int port = 0;
+    double ratio = 0;
+
+    std::ofstream("./schema.cfg") << "Name=valid\n[Server]\nPort=8080\nRatio=0.5\nWorkers=many\n[Client]\nRetries=99\n[Unknown]\nKey=value\n";
+    schema.allow("").allow("Server").allow("Client")
+          .expect<int>("Server:Port", 1, 65535).expect<double>("Server:Ratio").expect<int>("Server:Workers")
+          .expect<int>("Client:*", 0, 10).require("Name").require("Server:Host");
+    test.setSchema(schema);
+    test.relocate("./schema.cfg");
+
+    std::cout << "Converting values while loading => ";
+    test.get("Server:Port", port);
+    test.get("Server:Ratio", ratio);
+    std::cout << (port == 8080 && ratio == 0.5 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Collecting schema errors => ";
+    const std::vector<stb::ValidationError> &errors = test.errors();
+    std::cout << (!test.load() && errors.size() == 4
+                  && errors[0].line == 5 && errors[0].key == "Server:Workers"
+                  && errors[1].line == 7 && errors[1].key == "Client:Retries"
+                  && errors[2].line == 9 && errors[2].key == "Unknown:Key"
+                  && errors[3].line == 0 && errors[3].key == "Server:Host" ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Converting expanded values => ";
+    std::ofstream("./schema.cfg") << "Base=80\n[Server]\nPort=${Base}80\n";
+    stb::Schema typed;
+    typed.expect<int>("Server:Port", 1, 65535);
+    test.setSchema(typed);
+    bool loaded = test.load();
+    test.get("Server:Port", port);
+    std::cout << (loaded && port == 8080 && test.prefix("Server:Port").begin()->value().packed() ? "OK" : "FAIL") << "\n";
+    stb::Config::destroy("./schema.cfg");
+}
+
+void patch_tests()
+{
+    stb::Config before, after, target;
+    std::string buffer;
+
+    for (int i = 0; i < 100; i++)
+    {
+        before.set("Keys:Key" + std::to_string(i), i);
+    }
+    before.set("Old:Key", "removed");
+    after = before;
+    target = before;
+    after.set("Keys:Key42", "modified");
+    after.erase("Keys:Key7");
+    after.erase("Old:Key");
+    after.set("New:Key", "added");
+
+    std::cout << "Computing differences => ";
+    stb::Patch patch = stb::Patch::diff(before, after);
+    std::cout << (patch.size() == 4 && stb::Patch::diff(after, after).empty() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Applying a patch => ";
+    stb::Patch::parse(patch.str()).apply(target);
+    target.get("Keys:Key42", buffer);
+    std::cout << (buffer == "modified" && !target.exists("Keys:Key7") && !target.exists("Old:Key") && target.exists("New:Key")
+                  && stb::Patch::diff(target, after).empty() ? "OK" : "FAIL") << "\n";
+}
+
+struct BoundSettings
+{
+    std::string name;
+    int port;
+    bool verbose;
+    std::vector<int> ids;
+};
+
+void bind_tests()
+{
+    stb::Binding<BoundSettings> binding;
+    BoundSettings settings = {"", 0, false, std::vector<int>()};
+    stb::Config::destroy("./bind.cfg");
+    stb::Config test("./bind.cfg");
+
+    binding.bind("Name", &BoundSettings::name).bind("Server:Port", &BoundSettings::port)
+           .bind("Server:Verbose", &BoundSettings::verbose).bindContainer("Server:Ids", &BoundSettings::ids);
+    test.set("Name", "bound");
+    test.set("Server:Port", 8080);
+    test.set("Server:Verbose", true);
+    test.set("Server:Unbound", "kept");
+    test.setContainer("Server:Ids", std::vector<int>({1, 2, 3}));
+    test.save();
+
+    std::cout << "Loading file into struct => ";
+    bool complete = binding.load("./bind.cfg", settings);
+    std::cout << (complete && settings.name == "bound" && settings.port == 8080 && settings.verbose && settings.ids.size() == 3 && settings.ids[2] == 3 ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Saving struct into file => ";
+    settings.port = 9090;
+    settings.ids.push_back(4);
+    binding.save(settings, "./bind.cfg");
+    stb::Config reloaded("./bind.cfg");
+    BoundSettings loaded = {"", 0, false, std::vector<int>()};
+    binding.load(reloaded, loaded);
+    std::cout << (loaded.port == 9090 && loaded.ids.size() == 4 && loaded.name == "bound" && reloaded.exists("Server:Unbound") ? "OK" : "FAIL") << "\n";
+    stb::Config::destroy("./bind.cfg");
+}
+
+void change_tests()
+{
+    stb::Config test;
+    std::string buffer;
+
+    std::ofstream("./change.cfg") << "Name=before\n[Server]\nPort=8080\n";
+    test.relocate("./change.cfg");
+
+    std::cout << "Detecting modifications => ";
+    bool loaded = !test.modified() && !test.stale();
+    test.set("Server:Port", 8080);
+    bool same = !test.modified();
+    test.set("Server:Port", 9090);
+    bool changed = test.modified();
+    test.save();
+    std::cout << (loaded && same && changed && !test.modified() && !test.stale() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Reloading changed files only => ";
+    std::ofstream("./change.cfg") << "Name=after_\n[Server]\nPort=9090\n"; //Same size, within the same second
+    bool stale = test.stale();
+    test.reload();
+    test.get("Name", buffer);
+    test.set("Name", "modified");
+    test.reload();
+    std::string restored;
+    test.get("Name", restored);
+    std::cout << (stale && buffer == "after_" && restored == "after_" && !test.stale() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Saving keys set before loading => ";
+    stb::Config merged("./change.cfg");
+    merged.clear();
+    merged.set("Extra", "kept");
+    merged.load();
+    bool pending = merged.modified();
+    merged.save();
+    stb::Config saved("./change.cfg");
+    saved.get("Extra", buffer);
+    std::cout << (pending && buffer == "kept" && saved.exists("Server:Port") && !merged.modified() ? "OK" : "FAIL") << "\n";
+
+    std::cout << "Saving after an asynchronous save => ";
+    test.set("Name", "async");
+    test.saveAsync().get();
+    bool recorded = !test.modified() && !test.stale();
+    std::ofstream("./change.cfg") << "Name=outside\n"; //Written by another program
+    test.save(); //Stale file, written again
+    stb::Config written("./change.cfg");
+    written.get("Name", buffer);
+    std::cout << (recorded && buffer == "async" && !test.modified() && !test.stale() ? "OK" : "FAIL") << "\n";
+    stb::Config::destroy("./change.cfg");
+}
+
 int main(int argc, char **argv)
 {
     std::cout << "#####\nTinyConf Tests Program\n#####\n\n";
     std::cout << "#Basic tests:\n";
     basic_tests();
+    sections_tests();
     stb::Config::destroy("./test.cfg");
     stb::Config test("./test.cfg");
     std::cout << "\n#Primitives tests:\n";
@@ -227,6 +1051,42 @@ int main(int argc, char **argv)
     containers_tests(test);
     std::cout << "\n#Comments tests:\n";
     comments_tests(test);
+    std::cout << "\n#Syntax tests:\n";
+    syntax_tests();
+    std::cout << "\n#Stack tests:\n";
+    stack_tests();
+    std::cout << "\n#Interpolation tests:\n";
+    interpolation_tests();
+    std::cout << "\n#Async tests:\n";
+    async_tests();
+    std::cout << "\n#Set tests:\n";
+    set_tests();
+    std::cout << "\n#Memory tests:\n";
+    memory_tests();
+    std::cout << "\n#Iteration tests:\n";
+    iteration_tests();
+    std::cout << "\n#Freeze tests:\n";
+    freeze_tests();
+    std::cout << "\n#Copy tests:\n";
+    copy_tests();
+    std::cout << "\n#Shared tests:\n";
+    shared_tests();
+    std::cout << "\n#Embed tests:\n";
+    embed_tests();
+    std::cout << "\n#Bind tests:\n";
+    bind_tests();
+    std::cout << "\n#Version tests:\n";
+    version_tests();
+    std::cout << "\n#Patch tests:\n";
+    patch_tests();
+    std::cout << "\n#Transaction tests:\n";
+    transaction_tests();
+    std::cout << "\n#Mapping tests:\n";
+    mapping_tests();
+    std::cout << "\n#Schema tests:\n";
+    schema_tests();
+    std::cout << "\n#Change detection tests:\n";
+    change_tests();
     std::cout << "\nTests done!\n";
     return (0);
 }
\ No newline at end of file